@@ -0,0 +1,153 @@
+import argparse
+import math
+import os
+
+# Output directory of the reference models, relative to this script
+DEFAULT_OUTPUT = os.path.join(os.path.dirname(__file__), "..", "Resources", "Benchmarks")
+
+
+def generate_pile(num_bodies, columns):
+    """
+    Builds a scene of free bodies stacked in a loose grid above a plane, so they fall into a pile
+    and keep many contacts active.
+
+    Args:
+        num_bodies (int): Number of free bodies.
+        columns (int): Bodies per row and per column of each layer.
+
+    Returns:
+        str: The MJCF document.
+    """
+    lines = [
+        f"<!-- {num_bodies} free bodies falling into a pile. Generated by Scripts/generate_benchmark_models.py. -->",
+        f'<mujoco model="benchmark_pile_{num_bodies}">',
+        '  <option timestep="0.002"/>',
+        "  <size memory=\"256M\"/>",
+        "",
+        "  <worldbody>",
+        '    <light pos="0 0 10" dir="0 0 -1"/>',
+        '    <geom name="floor" type="plane" size="20 20 0.1" rgba="0.8 0.8 0.8 1"/>',
+    ]
+    spacing = 0.25
+    per_layer = columns * columns
+    for index in range(num_bodies):
+        layer, cell = divmod(index, per_layer)
+        row, column = divmod(cell, columns)
+        # Odd layers are offset by half a cell so the pile settles instead of stacking neatly
+        offset = spacing * 0.5 * (layer % 2)
+        x = (column - columns / 2) * spacing + offset
+        y = (row - columns / 2) * spacing + offset
+        z = 0.2 + layer * spacing
+        if index % 2 == 0:
+            geom = f'<geom type="box" size="0.08 0.08 0.08" rgba="0.2 0.4 0.8 1"/>'
+        else:
+            geom = f'<geom type="sphere" size="0.09" rgba="0.8 0.4 0.2 1"/>'
+        lines.append(f'    <body name="body{index}" pos="{x:.3f} {y:.3f} {z:.3f}"><freejoint/>{geom}</body>')
+    lines += ["  </worldbody>", "</mujoco>", ""]
+    return "\n".join(lines)
+
+
+def cylinder_mesh(radius, length, segments, rings):
+    """
+    Tessellates a closed cylinder along +z as an inline MuJoCo mesh.
+
+    Args:
+        radius (float): Cylinder radius.
+        length (float): Cylinder length.
+        segments (int): Vertices around the circumference.
+        rings (int): Vertex rings along the length.
+
+    Returns:
+        tuple[str, str]: The vertex and face attributes.
+    """
+    vertices = []
+    for ring in range(rings):
+        z = length * ring / (rings - 1)
+        for segment in range(segments):
+            angle = 2.0 * math.pi * segment / segments
+            vertices.append((radius * math.cos(angle), radius * math.sin(angle), z))
+    vertices.append((0.0, 0.0, 0.0))
+    vertices.append((0.0, 0.0, length))
+    bottom, top = len(vertices) - 2, len(vertices) - 1
+
+    faces = []
+    for ring in range(rings - 1):
+        for segment in range(segments):
+            a = ring * segments + segment
+            b = ring * segments + (segment + 1) % segments
+            faces.append((a, b, a + segments))
+            faces.append((b, b + segments, a + segments))
+    for segment in range(segments):
+        next_segment = (segment + 1) % segments
+        faces.append((bottom, next_segment, segment))
+        last = (rings - 1) * segments
+        faces.append((top, last + segment, last + next_segment))
+
+    vertex = " ".join(f"{x:.4f} {y:.4f} {z:.4f}" for x, y, z in vertices)
+    face = " ".join(f"{a} {b} {c}" for a, b, c in faces)
+    return vertex, face
+
+
+def generate_mesh_arm(num_links, segments, rings):
+    """
+    Builds a serial arm whose links are dense inline meshes, so mesh upload and sync dominate.
+
+    Args:
+        num_links (int): Number of hinge-jointed links.
+        segments (int): Vertices around each link.
+        rings (int): Vertex rings along each link.
+
+    Returns:
+        str: The MJCF document.
+    """
+    length = 0.3
+    vertex, face = cylinder_mesh(0.05, length, segments, rings)
+    lines = [
+        f"<!-- {num_links}-link arm of {segments * rings + 2}-vertex mesh links. Generated by Scripts/generate_benchmark_models.py. -->",
+        '<mujoco model="benchmark_mesh_arm">',
+        '  <option timestep="0.002"/>',
+        "",
+        "  <asset>",
+        f'    <mesh name="link" vertex="{vertex}" face="{face}"/>',
+        "  </asset>",
+        "",
+        "  <worldbody>",
+        '    <light pos="0 0 3" dir="0 0 -1"/>',
+        '    <geom name="floor" type="plane" size="5 5 0.1" rgba="0.8 0.8 0.8 1"/>',
+    ]
+    indent = "    "
+    for link in range(num_links):
+        position = "0 0 0.1" if link == 0 else f"0 0 {length}"
+        axis = "0 1 0" if link % 2 == 0 else "1 0 0"
+        lines.append(f'{indent}<body name="link{link}" pos="{position}">')
+        lines.append(f'{indent}  <joint name="joint{link}" type="hinge" axis="{axis}" damping="0.5"/>')
+        lines.append(f'{indent}  <geom type="mesh" mesh="link" rgba="0.6 0.6 0.7 1"/>')
+        indent += "  "
+    for link in reversed(range(num_links)):
+        indent = indent[:-2]
+        lines.append(f"{indent}</body>")
+    lines += ["  </worldbody>", "", "  <actuator>"]
+    for link in range(num_links):
+        lines.append(f'    <motor joint="joint{link}" gear="10" ctrlrange="-1 1" ctrllimited="true"/>')
+    lines += ["  </actuator>", "</mujoco>", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Regenerate the generated benchmark models")
+    parser.add_argument("--output", default=DEFAULT_OUTPUT, help="Directory to write the models to")
+    args = parser.parse_args()
+
+    models = {
+        "pile_1000.xml": generate_pile(1000, 10),
+        "mesh_arm.xml": generate_mesh_arm(7, 64, 32),
+    }
+    for name, document in models.items():
+        path = os.path.join(args.output, name)
+        with open(path, "w", newline="\n") as file:
+            file.write(document)
+        print(f"Wrote {path}")
+
+
+if __name__ == "__main__":
+    main()
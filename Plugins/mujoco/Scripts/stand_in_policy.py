@@ -0,0 +1,122 @@
+import argparse
+import mmap
+import math
+import os
+import struct
+import sys
+import time
+
+# Mirrors FMujocoPolicyBridgeHeader in MujocoPolicyBridge.h
+MAGIC = 0x42504A4D
+VERSION = 1
+HEADER_FORMAT = "<6I"
+OBSERVATION_SEQUENCE_OFFSET = 64
+ACTION_SEQUENCE_OFFSET = 128
+
+
+def open_segment(name, timeout):
+    """
+    Opens the shared memory segment created by FMujocoPolicyBridge, waiting for the simulation to create it.
+
+    Args:
+        name (str): Segment name, as configured on the manager (PolicyBridgeName).
+        timeout (float): Seconds to wait for the segment to appear.
+
+    Returns:
+        mmap.mmap: The mapped segment.
+    """
+    deadline = time.monotonic() + timeout
+    while True:
+        try:
+            if sys.platform == "win32":
+                segment = mmap.mmap(-1, 4096, tagname=name)
+            else:
+                fd = os.open(os.path.join("/dev/shm", name), os.O_RDWR)
+                segment = mmap.mmap(fd, 0)
+                os.close(fd)
+            magic, version = struct.unpack_from("<2I", segment, 0)
+            if magic == MAGIC and version == VERSION:
+                return segment
+            segment.close()
+        except OSError:
+            pass
+
+        if time.monotonic() > deadline:
+            raise TimeoutError(f"Shared memory segment '{name}' did not appear")
+        time.sleep(0.05)
+
+
+def compute_actions(mode, observations, num_actions, gain):
+    """
+    Stand-in for a real policy.
+
+    Args:
+        mode (str): "zero", "sine" or "damping".
+        observations (tuple): Observation vector; element 0 is simulation time.
+        num_actions (int): Number of actions to produce.
+        gain (float): Amplitude for "sine", damping gain for "damping".
+
+    Returns:
+        list: num_actions floats.
+    """
+    if mode == "sine":
+        return [gain * math.sin(2.0 * math.pi * observations[0] + i) for i in range(num_actions)]
+    if mode == "damping":
+        # Observations are [time, qpos..., qvel...]; push against the last num_actions velocities
+        velocities = observations[-num_actions:] if num_actions else ()
+        return [-gain * v for v in velocities]
+    return [0.0] * num_actions
+
+
+def serve(name, mode, gain, timeout):
+    segment = open_segment(name, timeout)
+    _, _, num_observations, num_actions, observation_offset, action_offset = struct.unpack_from(HEADER_FORMAT, segment, 0)
+    if sys.platform == "win32":
+        # Named mappings on Windows have to be opened with their full size
+        segment.close()
+        segment = mmap.mmap(-1, action_offset + 8 * num_actions, tagname=name)
+    print(f"Connected to '{name}': {num_observations} observations, {num_actions} actions")
+
+    observation_format = f"<{num_observations}d"
+    action_format = f"<{num_actions}d"
+    last_sequence = struct.unpack_from("<Q", segment, ACTION_SEQUENCE_OFFSET)[0]
+    served = 0
+    busy = 0.0
+    report_at = time.monotonic() + 1.0
+
+    while True:
+        # Busy-poll like the simulation does; sleeping here would dominate the round trip
+        sequence = struct.unpack_from("<Q", segment, OBSERVATION_SEQUENCE_OFFSET)[0]
+        if sequence == last_sequence:
+            if time.monotonic() > report_at:
+                report_at = time.monotonic() + 1.0
+                if served:
+                    print(f"{served} steps/s, {1e6 * busy / served:.1f} us per step in the policy")
+                served = 0
+                busy = 0.0
+            continue
+
+        start = time.perf_counter()
+        observations = struct.unpack_from(observation_format, segment, observation_offset)
+        actions = compute_actions(mode, observations, num_actions, gain)
+        struct.pack_into(action_format, segment, action_offset, *actions)
+
+        # Actions must land before the sequence; x86 keeps plain stores in order, which is all a stand-in needs
+        struct.pack_into("<Q", segment, ACTION_SEQUENCE_OFFSET, sequence)
+        busy += time.perf_counter() - start
+        last_sequence = sequence
+        served += 1
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Stand-in policy process for the MuJoCo shared memory bridge.")
+    parser.add_argument("-n", "--name", default="mujoco_policy", help="Shared memory segment name")
+    parser.add_argument("-m", "--mode", choices=["zero", "sine", "damping"], default="zero", help="Action rule")
+    parser.add_argument("-g", "--gain", type=float, default=1.0, help="Amplitude or damping gain")
+    parser.add_argument("-t", "--timeout", type=float, default=60.0, help="Seconds to wait for the simulation")
+    args = parser.parse_args()
+
+    try:
+        serve(args.name, args.mode, args.gain, args.timeout)
+    except KeyboardInterrupt:
+        pass
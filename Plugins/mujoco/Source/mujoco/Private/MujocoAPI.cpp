@@ -18,9 +18,37 @@ FMujocoAPI::FMujocoAPI()
       Mj_Step(nullptr),
       Mj_Forward(nullptr),
       Mj_ResetData(nullptr),
+      Mj_Kinematics(nullptr),
+      Mj_StateSize(nullptr),
+      Mj_GetState(nullptr),
+      Mj_SetState(nullptr),
       Mj_MakeData(nullptr),
+      Mj_CopyData(nullptr),
+      Mj_Name2Id(nullptr),
+      Mj_MultiRay(nullptr),
+      Mju_RayGeom(nullptr),
+      Mj_ContactForce(nullptr),
+      Mj_MakeSpec(nullptr),
+      Mj_ParseXML(nullptr),
+      Mjs_GetError(nullptr),
+      Mjs_FindBody(nullptr),
+      Mjs_FirstChild(nullptr),
+      Mjs_NextChild(nullptr),
+      Mjs_AsBody(nullptr),
+      Mjs_AddFrame(nullptr),
+      Mjs_AttachBody(nullptr),
+      Mjs_GetId(nullptr),
+      Mj_Recompile(nullptr),
+      Mjs_AddBody(nullptr),
+      Mjs_AddGeom(nullptr),
+      Mjs_AddFreeJoint(nullptr),
+      Mjs_DetachBody(nullptr),
+      Mjs_FirstElement(nullptr),
+      Mjs_NextElement(nullptr),
+      Mjs_SetString(nullptr),
       Mj_DeleteData(nullptr),
-      Mj_DeleteModel(nullptr) {}
+      Mj_DeleteModel(nullptr),
+      Mju_UserError(nullptr) {}
 
 FMujocoAPI::~FMujocoAPI() {
   UnloadMuJoCo();
@@ -67,16 +95,79 @@ bool FMujocoAPI::LoadMuJoCo() {
     MuJoCoHandle, TEXT("mj_forward")));
   Mj_ResetData = static_cast<Mj_ResetDataFunc>(FPlatformProcess::GetDllExport(
     MuJoCoHandle, TEXT("mj_resetData")));
+  Mj_Kinematics = static_cast<Mj_KinematicsFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_kinematics")));
+  Mj_StateSize = static_cast<Mj_StateSizeFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_stateSize")));
+  Mj_GetState = static_cast<Mj_GetStateFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_getState")));
+  Mj_SetState = static_cast<Mj_SetStateFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_setState")));
   Mj_MakeData = static_cast<Mj_MakeDataFunc>(FPlatformProcess::GetDllExport(
     MuJoCoHandle, TEXT("mj_makeData")));
+  Mj_CopyData = static_cast<Mj_CopyDataFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_copyData")));
+  Mj_Name2Id = static_cast<Mj_Name2IdFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_name2id")));
+  Mj_MultiRay = static_cast<Mj_MultiRayFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_multiRay")));
+  Mju_RayGeom = static_cast<Mju_RayGeomFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mju_rayGeom")));
+  Mj_ContactForce = static_cast<Mj_ContactForceFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_contactForce")));
+  Mj_MakeSpec = static_cast<Mj_MakeSpecFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_makeSpec")));
+  Mj_ParseXML = static_cast<Mj_ParseXMLFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_parseXML")));
+  Mjs_GetError = static_cast<Mjs_GetErrorFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_getError")));
+  Mjs_FindBody = static_cast<Mjs_FindBodyFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_findBody")));
+  Mjs_FirstChild = static_cast<Mjs_FirstChildFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_firstChild")));
+  Mjs_NextChild = static_cast<Mjs_NextChildFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_nextChild")));
+  Mjs_AsBody = static_cast<Mjs_AsBodyFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_asBody")));
+  Mjs_AddFrame = static_cast<Mjs_AddFrameFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_addFrame")));
+  Mjs_AttachBody = static_cast<Mjs_AttachBodyFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_attachBody")));
+  Mjs_GetId = static_cast<Mjs_GetIdFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_getId")));
+  Mj_Recompile = static_cast<Mj_RecompileFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mj_recompile")));
+  Mjs_AddBody = static_cast<Mjs_AddBodyFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_addBody")));
+  Mjs_AddGeom = static_cast<Mjs_AddGeomFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_addGeom")));
+  Mjs_AddFreeJoint = static_cast<Mjs_AddFreeJointFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_addFreeJoint")));
+  Mjs_DetachBody = static_cast<Mjs_DetachBodyFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_detachBody")));
+  Mjs_FirstElement = static_cast<Mjs_FirstElementFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_firstElement")));
+  Mjs_NextElement = static_cast<Mjs_NextElementFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_nextElement")));
+  Mjs_SetString = static_cast<Mjs_SetStringFunc>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mjs_setString")));
   Mj_DeleteData = static_cast<Mj_DeleteDataFunc>(FPlatformProcess::GetDllExport(
     MuJoCoHandle, TEXT("mj_deleteData")));
   Mj_DeleteModel = static_cast<Mj_DeleteModelFunc>(FPlatformProcess::GetDllExport(
     MuJoCoHandle, TEXT("mj_deleteModel")));
+  Mju_UserError = static_cast<Mju_ErrorHandlerFunc*>(FPlatformProcess::GetDllExport(
+    MuJoCoHandle, TEXT("mju_user_error")));
 
   if (!Mj_Version || !Mj_VersionString || !Mj_ParseXMLString || !Mj_Compile ||
       !Mj_DeleteSpec || !Mj_Step || !Mj_Forward || !Mj_ResetData ||
-      !Mj_MakeData || !Mj_DeleteData || !Mj_DeleteModel || !Mj_LoadXML) {
+      !Mj_MakeData || !Mj_DeleteData || !Mj_DeleteModel || !Mj_LoadXML ||
+      !Mj_Kinematics || !Mj_StateSize || !Mj_GetState || !Mj_SetState ||
+      !Mj_CopyData || !Mj_Name2Id || !Mj_MultiRay || !Mju_RayGeom ||
+      !Mj_ContactForce || !Mj_MakeSpec || !Mj_ParseXML || !Mjs_GetError ||
+      !Mjs_FindBody || !Mjs_FirstChild || !Mjs_NextChild || !Mjs_AsBody ||
+      !Mjs_AddFrame || !Mjs_AttachBody || !Mjs_GetId || !Mj_Recompile ||
+      !Mjs_AddBody || !Mjs_AddGeom || !Mjs_AddFreeJoint || !Mjs_DetachBody ||
+      !Mjs_FirstElement || !Mjs_NextElement || !Mjs_SetString) {
     UE_LOG(LogMujocoAPI, Error, TEXT("Failed to bind MuJoCo functions."));
     UnloadMuJoCo();
     return false;
@@ -99,9 +190,37 @@ void FMujocoAPI::UnloadMuJoCo() {
     Mj_Step = nullptr;
     Mj_Forward = nullptr;
     Mj_ResetData = nullptr;
+    Mj_Kinematics = nullptr;
+    Mj_StateSize = nullptr;
+    Mj_GetState = nullptr;
+    Mj_SetState = nullptr;
     Mj_MakeData = nullptr;
+    Mj_CopyData = nullptr;
+    Mj_Name2Id = nullptr;
+    Mj_MultiRay = nullptr;
+    Mju_RayGeom = nullptr;
+    Mj_ContactForce = nullptr;
+    Mj_MakeSpec = nullptr;
+    Mj_ParseXML = nullptr;
+    Mjs_GetError = nullptr;
+    Mjs_FindBody = nullptr;
+    Mjs_FirstChild = nullptr;
+    Mjs_NextChild = nullptr;
+    Mjs_AsBody = nullptr;
+    Mjs_AddFrame = nullptr;
+    Mjs_AttachBody = nullptr;
+    Mjs_GetId = nullptr;
+    Mj_Recompile = nullptr;
+    Mjs_AddBody = nullptr;
+    Mjs_AddGeom = nullptr;
+    Mjs_AddFreeJoint = nullptr;
+    Mjs_DetachBody = nullptr;
+    Mjs_FirstElement = nullptr;
+    Mjs_NextElement = nullptr;
+    Mjs_SetString = nullptr;
     Mj_DeleteData = nullptr;
     Mj_DeleteModel = nullptr;
+    Mju_UserError = nullptr;
 
     UE_LOG(LogMujocoAPI, Log, TEXT("MuJoCo successfully unloaded."));
   }
@@ -175,6 +294,155 @@ void FMujocoAPI::FreeSpec(mjSpec* Spec) const
   }
 }
 
+mjSpec* FMujocoAPI::MakeSpec() const
+{
+  if (!Mj_MakeSpec) {
+    UE_LOG(LogMujocoAPI, Error,
+           TEXT("MuJoCo function pointer 'mj_makeSpec' is null."));
+    return nullptr;
+  }
+
+  return Mj_MakeSpec();
+}
+
+mjSpec* FMujocoAPI::ParseXMLFile(const FString& Filename) const
+{
+  if (!Mj_ParseXML) {
+    UE_LOG(LogMujocoAPI, Error,
+           TEXT("MuJoCo function pointer 'mj_parseXML' is null."));
+    return nullptr;
+  }
+
+  const std::string PathStr = TCHAR_TO_UTF8(*Filename);
+  char Error[1024] = "";
+  mjSpec* Spec = Mj_ParseXML(PathStr.c_str(), nullptr, Error, sizeof(Error));
+
+  if (!Spec) {
+    UE_LOG(LogMujocoAPI, Error, TEXT("Failed to parse MuJoCo XML: %s"),
+           UTF8_TO_TCHAR(Error));
+  }
+
+  return Spec;
+}
+
+FString FMujocoAPI::GetSpecError(mjSpec* Spec) const
+{
+  return Mjs_GetError && Spec ? FString(UTF8_TO_TCHAR(Mjs_GetError(Spec)))
+                              : FString();
+}
+
+mjsBody* FMujocoAPI::FindSpecBody(mjSpec* Spec, const char* Name) const
+{
+  return Mjs_FindBody && Spec ? Mjs_FindBody(Spec, Name) : nullptr;
+}
+
+mjsElement* FMujocoAPI::FirstChild(mjsBody* Body, mjtObj Type,
+                                   bool bRecurse) const
+{
+  return Mjs_FirstChild && Body ? Mjs_FirstChild(Body, Type, bRecurse ? 1 : 0)
+                                : nullptr;
+}
+
+mjsElement* FMujocoAPI::NextChild(mjsBody* Body, mjsElement* Child,
+                                  bool bRecurse) const
+{
+  return Mjs_NextChild && Body && Child
+             ? Mjs_NextChild(Body, Child, bRecurse ? 1 : 0)
+             : nullptr;
+}
+
+mjsBody* FMujocoAPI::AsBody(mjsElement* Element) const
+{
+  return Mjs_AsBody && Element ? Mjs_AsBody(Element) : nullptr;
+}
+
+mjsFrame* FMujocoAPI::AddFrame(mjsBody* Body, mjsFrame* ParentFrame) const
+{
+  return Mjs_AddFrame && Body ? Mjs_AddFrame(Body, ParentFrame) : nullptr;
+}
+
+mjsBody* FMujocoAPI::AttachBody(mjsFrame* Parent, const mjsBody* Child,
+                                const FString& Prefix,
+                                const FString& Suffix) const
+{
+  if (!Mjs_AttachBody || !Parent || !Child) {
+    return nullptr;
+  }
+
+  const std::string PrefixStr = TCHAR_TO_UTF8(*Prefix);
+  const std::string SuffixStr = TCHAR_TO_UTF8(*Suffix);
+  return Mjs_AttachBody(Parent, Child, PrefixStr.c_str(), SuffixStr.c_str());
+}
+
+int FMujocoAPI::GetElementId(mjsElement* Element) const
+{
+  return Mjs_GetId && Element ? Mjs_GetId(Element) : -1;
+}
+
+bool FMujocoAPI::RecompileSpec(mjSpec* Spec, mjModel* Model,
+                               mjData* Data) const
+{
+  if (!Mj_Recompile) {
+    UE_LOG(LogMujocoAPI, Error,
+           TEXT("MuJoCo function pointer 'mj_recompile' is null."));
+    return false;
+  }
+
+  return Spec && Model && Data && Mj_Recompile(Spec, nullptr, Model, Data) == 0;
+}
+
+mjsBody* FMujocoAPI::AddBody(mjsBody* Parent) const
+{
+  return Mjs_AddBody && Parent ? Mjs_AddBody(Parent, nullptr) : nullptr;
+}
+
+mjsGeom* FMujocoAPI::AddGeom(mjsBody* Body) const
+{
+  return Mjs_AddGeom && Body ? Mjs_AddGeom(Body, nullptr) : nullptr;
+}
+
+mjsJoint* FMujocoAPI::AddFreeJoint(mjsBody* Body) const
+{
+  return Mjs_AddFreeJoint && Body ? Mjs_AddFreeJoint(Body) : nullptr;
+}
+
+bool FMujocoAPI::DetachBody(mjSpec* Spec, mjsBody* Body) const
+{
+  return Mjs_DetachBody && Spec && Body && Mjs_DetachBody(Spec, Body) == 0;
+}
+
+bool FMujocoAPI::SetErrorHandler(void (*Handler)(const char*)) const
+{
+  if (!Mju_UserError) {
+    UE_LOG(LogMujocoAPI, Warning,
+           TEXT("MuJoCo variable 'mju_user_error' is not exported."));
+    return false;
+  }
+
+  *Mju_UserError = Handler;
+  return true;
+}
+
+mjsElement* FMujocoAPI::FirstElement(mjSpec* Spec, mjtObj Type) const
+{
+  return Mjs_FirstElement && Spec ? Mjs_FirstElement(Spec, Type) : nullptr;
+}
+
+mjsElement* FMujocoAPI::NextElement(mjSpec* Spec, mjsElement* Element) const
+{
+  return Mjs_NextElement && Spec && Element ? Mjs_NextElement(Spec, Element)
+                                            : nullptr;
+}
+
+void FMujocoAPI::SetSpecString(mjString* Destination,
+                               const FString& Text) const
+{
+  if (Mjs_SetString && Destination) {
+    const std::string TextStr = TCHAR_TO_UTF8(*Text);
+    Mjs_SetString(Destination, TextStr.c_str());
+  }
+}
+
 mjData* FMujocoAPI::CreateData(const mjModel* Model) const
 {
   if (!Mj_MakeData) {
@@ -186,6 +454,22 @@ mjData* FMujocoAPI::CreateData(const mjModel* Model) const
   return Mj_MakeData(Model);
 }
 
+mjData* FMujocoAPI::CopyData(const mjModel* Model, const mjData* Source,
+                             mjData* Destination) const
+{
+  if (!Mj_CopyData) {
+    UE_LOG(LogMujocoAPI, Error,
+           TEXT("MuJoCo function pointer 'mj_copyData' is null."));
+    return nullptr;
+  }
+
+  if (!Model || !Source || !Destination) {
+    return nullptr;
+  }
+
+  return Mj_CopyData(Destination, Model, Source);
+}
+
 void FMujocoAPI::FreeData(mjData* Data) const
 {
   if (Mj_DeleteData && Data) {
@@ -220,3 +504,75 @@ void FMujocoAPI::ResetData(const mjModel* Model, mjData* Data) const
     Mj_ResetData(Model, Data);
   }
 }
+
+void FMujocoAPI::Kinematics(const mjModel* Model, mjData* Data) const
+{
+  if (Mj_Kinematics && Model && Data) {
+    Mj_Kinematics(Model, Data);
+  }
+}
+
+int FMujocoAPI::GetStateSize(const mjModel* Model, unsigned int Spec) const
+{
+  return Mj_StateSize && Model ? Mj_StateSize(Model, Spec) : 0;
+}
+
+void FMujocoAPI::GetState(const mjModel* Model, const mjData* Data,
+                          mjtNum* State, unsigned int Spec) const
+{
+  if (Mj_GetState && Model && Data && State) {
+    Mj_GetState(Model, Data, State, Spec);
+  }
+}
+
+void FMujocoAPI::SetState(const mjModel* Model, mjData* Data,
+                          const mjtNum* State, unsigned int Spec) const
+{
+  if (Mj_SetState && Model && Data && State) {
+    Mj_SetState(Model, Data, State, Spec);
+  }
+}
+
+int FMujocoAPI::NameToId(const mjModel* Model, int Type,
+                         const FString& Name) const
+{
+  if (!Mj_Name2Id || !Model) {
+    return -1;
+  }
+
+  const std::string NameStr = TCHAR_TO_UTF8(*Name);
+  return Mj_Name2Id(Model, Type, NameStr.c_str());
+}
+
+void FMujocoAPI::MultiRay(const mjModel* Model, mjData* Data,
+                          const mjtNum* Origin, const mjtNum* Directions,
+                          const mjtByte* GeomGroup, bool bIncludeStatic,
+                          int BodyExclude, int* GeomIds, mjtNum* Distances,
+                          int NumRays, mjtNum Cutoff) const
+{
+  if (Mj_MultiRay && Model && Data && NumRays > 0) {
+    Mj_MultiRay(Model, Data, Origin, Directions, GeomGroup,
+                bIncludeStatic ? 1 : 0, BodyExclude, GeomIds, Distances,
+                NumRays, Cutoff);
+  }
+}
+
+mjtNum FMujocoAPI::RayGeom(const mjtNum* Position, const mjtNum* Orientation,
+                           const mjtNum* Size, const mjtNum* Origin,
+                           const mjtNum* Direction, int GeomType) const
+{
+  return Mju_RayGeom ? Mju_RayGeom(Position, Orientation, Size, Origin,
+                                   Direction, GeomType)
+                     : -1;
+}
+
+void FMujocoAPI::ContactForce(const mjModel* Model, const mjData* Data,
+                              int ContactId, mjtNum Result[6]) const
+{
+  if (Mj_ContactForce && Model && Data && ContactId >= 0 &&
+      ContactId < Data->ncon) {
+    Mj_ContactForce(Model, Data, ContactId, Result);
+  } else {
+    FMemory::Memzero(Result, 6 * sizeof(mjtNum));
+  }
+}
@@ -0,0 +1,157 @@
+#include "MujocoPolicyBridge.h"
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY(LogMujocoPolicyBridge);
+
+namespace {
+// Busy-wait this many times before yielding the core while waiting for the
+// policy; a reply normally arrives well within the spin window.
+constexpr int32 SpinsBeforeYield = 4096;
+
+uint32 AlignTo64(const uint32 Offset) { return (Offset + 63u) & ~63u; }
+}  // namespace
+
+FMujocoPolicyBridge::~FMujocoPolicyBridge() { Close(); }
+
+bool FMujocoPolicyBridge::Create(const FString& Name, int32 NumObservations,
+                                 int32 NumActions)
+{
+  Close();
+
+  if (Name.IsEmpty() || NumObservations < 0 || NumActions < 0) {
+    UE_LOG(LogMujocoPolicyBridge, Error, TEXT("Invalid policy bridge layout."));
+    return false;
+  }
+
+  const uint32 ObservationOffset = AlignTo64(sizeof(FMujocoPolicyBridgeHeader));
+  const uint32 ActionOffset =
+      AlignTo64(ObservationOffset + NumObservations * sizeof(double));
+  const SIZE_T Size = ActionOffset + NumActions * sizeof(double);
+
+  Region = FPlatformMemory::MapNamedSharedMemoryRegion(
+      Name, true,
+      FPlatformMemory::ESharedMemoryAccess::Read |
+          FPlatformMemory::ESharedMemoryAccess::Write,
+      Size);
+  if (!Region) {
+    UE_LOG(LogMujocoPolicyBridge, Error,
+           TEXT("Failed to map shared memory segment '%s'."), *Name);
+    return false;
+  }
+
+  uint8* Base = static_cast<uint8*>(Region->GetAddress());
+  FMemory::Memzero(Base, Size);
+
+  // Sequences go in first so a policy polling the segment never sees a
+  // published observation before the layout is complete.
+  Header = new (Base) FMujocoPolicyBridgeHeader();
+  Header->ObservationSequence.store(0, std::memory_order_relaxed);
+  Header->ActionSequence.store(0, std::memory_order_relaxed);
+  Header->NumObservations = NumObservations;
+  Header->NumActions = NumActions;
+  Header->ObservationOffset = ObservationOffset;
+  Header->ActionOffset = ActionOffset;
+  Header->Version = FMujocoPolicyBridgeHeader::ExpectedVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  Header->Magic = FMujocoPolicyBridgeHeader::ExpectedMagic;
+
+  NextSequence = 1;
+
+  UE_LOG(LogMujocoPolicyBridge, Log,
+         TEXT("Policy bridge '%s' ready: %d observations, %d actions."), *Name,
+         NumObservations, NumActions);
+  return true;
+}
+
+void FMujocoPolicyBridge::Close()
+{
+  if (Region) {
+    FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+    Region = nullptr;
+  }
+  Header = nullptr;
+}
+
+TArrayView<double> FMujocoPolicyBridge::GetObservations() const
+{
+  if (!Header) {
+    return TArrayView<double>();
+  }
+  return TArrayView<double>(
+      reinterpret_cast<double*>(reinterpret_cast<uint8*>(Header) +
+                                Header->ObservationOffset),
+      Header->NumObservations);
+}
+
+TArrayView<const double> FMujocoPolicyBridge::GetActions() const
+{
+  if (!Header) {
+    return TArrayView<const double>();
+  }
+  return TArrayView<const double>(
+      reinterpret_cast<const double*>(reinterpret_cast<const uint8*>(Header) +
+                                      Header->ActionOffset),
+      Header->NumActions);
+}
+
+uint64 FMujocoPolicyBridge::Publish()
+{
+  if (!Header) {
+    return 0;
+  }
+
+  const uint64 Sequence = NextSequence++;
+  Header->ObservationSequence.store(Sequence, std::memory_order_release);
+  return Sequence;
+}
+
+bool FMujocoPolicyBridge::WaitForActions(uint64 Sequence,
+                                         double TimeoutSeconds) const
+{
+  if (!Header || Sequence == 0) {
+    return false;
+  }
+
+  const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+  for (int32 Spin = 0;; ++Spin) {
+    if (Header->ActionSequence.load(std::memory_order_acquire) == Sequence) {
+      return true;
+    }
+
+    if (Spin < SpinsBeforeYield) {
+      FPlatformProcess::YieldCycles(64);
+      continue;
+    }
+
+    if (FPlatformTime::Seconds() > Deadline) {
+      return false;
+    }
+    FPlatformProcess::Yield();
+  }
+}
+
+bool FMujocoPolicyBridge::Exchange(TConstArrayView<double> Observations,
+                                   TArrayView<double> OutActions,
+                                   double TimeoutSeconds)
+{
+  if (!Header) {
+    return false;
+  }
+
+  const TArrayView<double> Shared = GetObservations();
+  FMemory::Memcpy(Shared.GetData(), Observations.GetData(),
+                  FMath::Min(Shared.Num(), Observations.Num()) *
+                      sizeof(double));
+
+  if (!WaitForActions(Publish(), TimeoutSeconds)) {
+    return false;
+  }
+
+  const TArrayView<const double> Actions = GetActions();
+  FMemory::Memcpy(OutActions.GetData(), Actions.GetData(),
+                  FMath::Min(Actions.Num(), OutActions.Num()) *
+                      sizeof(double));
+  return true;
+}
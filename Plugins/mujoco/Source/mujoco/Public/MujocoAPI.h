@@ -76,6 +76,147 @@ public:
      */
     void FreeSpec(mjSpec* Spec) const;
 
+    /**
+     * @brief Creates an empty MuJoCo specification.
+     * @return Pointer to the new mjSpec, or nullptr on failure.
+     */
+    mjSpec* MakeSpec() const;
+
+    /**
+     * @brief Parses an XML file into a MuJoCo specification object.
+     * @param Filename The path to the XML file.
+     * @return Pointer to the parsed mjSpec, or nullptr on failure.
+     */
+    mjSpec* ParseXMLFile(const FString& Filename) const;
+
+    /**
+     * @brief Returns the compiler error of the last failed operation on a spec.
+     * @param Spec Pointer to the MuJoCo specification.
+     * @return Error message, empty if none.
+     */
+    FString GetSpecError(mjSpec* Spec) const;
+
+    /**
+     * @brief Finds a body in a spec by name; "world" is the world body.
+     * @param Spec Pointer to the MuJoCo specification.
+     * @param Name Name of the body.
+     * @return Pointer to the body, or nullptr if not found.
+     */
+    mjsBody* FindSpecBody(mjSpec* Spec, const char* Name) const;
+
+    /**
+     * @brief Returns the first child element of a given type of a spec body.
+     * @param Body Parent body.
+     * @param Type Element type (mjtObj).
+     * @param bRecurse Whether to search the whole subtree.
+     * @return First child, or nullptr if there is none.
+     */
+    mjsElement* FirstChild(mjsBody* Body, mjtObj Type, bool bRecurse) const;
+
+    /**
+     * @brief Returns the next child element of the same type as Child.
+     * @param Body Parent body.
+     * @param Child Current child.
+     * @param bRecurse Whether to search the whole subtree.
+     * @return Next child, or nullptr if Child was the last.
+     */
+    mjsElement* NextChild(mjsBody* Body, mjsElement* Child, bool bRecurse) const;
+
+    /**
+     * @brief Casts a spec element to a body.
+     * @param Element Spec element.
+     * @return The body, or nullptr if Element is not a body.
+     */
+    mjsBody* AsBody(mjsElement* Element) const;
+
+    /**
+     * @brief Adds a frame to a spec body.
+     * @param Body Parent body.
+     * @param ParentFrame Enclosing frame, or nullptr.
+     * @return Pointer to the new frame, or nullptr on failure.
+     */
+    mjsFrame* AddFrame(mjsBody* Body, mjsFrame* ParentFrame) const;
+
+    /**
+     * @brief Attaches a copy of a body subtree (possibly of another spec) to a frame.
+     * @param Parent Frame to attach to.
+     * @param Child Root of the subtree to copy.
+     * @param Prefix Prefix added to every name in the copy.
+     * @param Suffix Suffix added to every name in the copy.
+     * @return The attached body, or nullptr on failure.
+     */
+    mjsBody* AttachBody(mjsFrame* Parent, const mjsBody* Child,
+                        const FString& Prefix, const FString& Suffix) const;
+
+    /**
+     * @brief Returns the id a spec element was given by the last compilation.
+     * @param Element Spec element.
+     * @return Id in the compiled model, or -1 if not compiled.
+     */
+    int GetElementId(mjsElement* Element) const;
+
+    /**
+     * @brief Recompiles an edited spec into an existing model and data,
+     * carrying the simulation state over to the new model.
+     * @param Spec Pointer to the MuJoCo specification Model was compiled from.
+     * @param Model Model to overwrite in place.
+     * @param Data Data to resize in place.
+     * @return True on success.
+     */
+    bool RecompileSpec(mjSpec* Spec, mjModel* Model, mjData* Data) const;
+
+    /**
+     * @brief Adds a child body to a spec body.
+     * @param Parent Parent body.
+     * @return Pointer to the new body, or nullptr on failure.
+     */
+    mjsBody* AddBody(mjsBody* Parent) const;
+
+    /**
+     * @brief Adds a geom to a spec body.
+     * @param Body Owning body.
+     * @return Pointer to the new geom, or nullptr on failure.
+     */
+    mjsGeom* AddGeom(mjsBody* Body) const;
+
+    /**
+     * @brief Adds a free joint to a spec body.
+     * @param Body Owning body.
+     * @return Pointer to the new joint, or nullptr on failure.
+     */
+    mjsJoint* AddFreeJoint(mjsBody* Body) const;
+
+    /**
+     * @brief Deletes a body subtree and every element referencing it from a spec.
+     * @param Spec Pointer to the MuJoCo specification.
+     * @param Body Body to delete.
+     * @return True on success.
+     */
+    bool DetachBody(mjSpec* Spec, mjsBody* Body) const;
+
+    /**
+     * @brief Returns the first element of a given type in a spec.
+     * @param Spec Pointer to the MuJoCo specification.
+     * @param Type Element type (mjtObj).
+     * @return First element, or nullptr if there is none.
+     */
+    mjsElement* FirstElement(mjSpec* Spec, mjtObj Type) const;
+
+    /**
+     * @brief Returns the element of the same type following Element in a spec.
+     * @param Spec Pointer to the MuJoCo specification.
+     * @param Element Current element.
+     * @return Next element, or nullptr if Element was the last.
+     */
+    mjsElement* NextElement(mjSpec* Spec, mjsElement* Element) const;
+
+    /**
+     * @brief Assigns a spec string attribute such as a name.
+     * @param Destination String attribute of a spec element.
+     * @param Text New value.
+     */
+    void SetSpecString(mjString* Destination, const FString& Text) const;
+
     // Simulation Functions
 
     /**
@@ -99,6 +240,100 @@ public:
      */
     void ResetData(const mjModel* Model, mjData* Data) const;
 
+    /**
+     * @brief Runs forward kinematics only (body, geom and site poses), without
+     * dynamics.
+     * @param Model Pointer to the MuJoCo model.
+     * @param Data Pointer to the simulation data.
+     */
+    void Kinematics(const mjModel* Model, mjData* Data) const;
+
+    // State Management
+
+    /**
+     * @brief Returns the number of mjtNum values in a state of the given spec.
+     * @param Model Pointer to the MuJoCo model.
+     * @param Spec Bitfield of mjtState flags selecting the state components.
+     * @return State size, or 0 if not available.
+     */
+    int GetStateSize(const mjModel* Model, unsigned int Spec) const;
+
+    /**
+     * @brief Copies the selected state components out of the simulation data.
+     * @param Model Pointer to the MuJoCo model.
+     * @param Data Pointer to the simulation data.
+     * @param State Destination buffer of GetStateSize(Model, Spec) values.
+     * @param Spec Bitfield of mjtState flags selecting the state components.
+     */
+    void GetState(const mjModel* Model, const mjData* Data, mjtNum* State,
+                  unsigned int Spec) const;
+
+    /**
+     * @brief Writes the selected state components into the simulation data.
+     * @param Model Pointer to the MuJoCo model.
+     * @param Data Pointer to the simulation data.
+     * @param State Source buffer of GetStateSize(Model, Spec) values.
+     * @param Spec Bitfield of mjtState flags selecting the state components.
+     */
+    void SetState(const mjModel* Model, mjData* Data, const mjtNum* State,
+                  unsigned int Spec) const;
+
+    // Queries
+
+    /**
+     * @brief Looks up the id of a named model object (linear search).
+     * @param Model Pointer to the MuJoCo model.
+     * @param Type Object type (mjtObj).
+     * @param Name Name of the object.
+     * @return Object id, or -1 if not found.
+     */
+    int NameToId(const mjModel* Model, int Type, const FString& Name) const;
+
+    /**
+     * @brief Intersects multiple rays emanating from a single point with the
+     * model geoms.
+     * @param Model Pointer to the MuJoCo model.
+     * @param Data Pointer to the simulation data; its stack is used as scratch.
+     * @param Origin Ray origin (3 values).
+     * @param Directions Ray directions (NumRays x 3 values).
+     * @param GeomGroup Per-group inclusion flags (mjNGROUP), or nullptr for all.
+     * @param bIncludeStatic Whether geoms of static bodies are included.
+     * @param BodyExclude Body whose geoms are skipped, or -1.
+     * @param GeomIds Output hit geom ids (NumRays), -1 on miss.
+     * @param Distances Output hit distances (NumRays), -1 on miss.
+     * @param NumRays Number of rays.
+     * @param Cutoff Maximum distance considered.
+     */
+    void MultiRay(const mjModel* Model, mjData* Data, const mjtNum* Origin,
+                  const mjtNum* Directions, const mjtByte* GeomGroup,
+                  bool bIncludeStatic, int BodyExclude, int* GeomIds,
+                  mjtNum* Distances, int NumRays, mjtNum Cutoff) const;
+
+    /**
+     * @brief Intersects a ray with a single primitive geom (no mesh or height
+     * field). Thread-safe; does not touch mjData.
+     * @param Position Geom position (3 values).
+     * @param Orientation Geom orientation matrix (9 values, row-major).
+     * @param Size Geom size (3 values).
+     * @param Origin Ray origin (3 values).
+     * @param Direction Ray direction (3 values).
+     * @param GeomType Geom type (mjtGeom).
+     * @return Distance along Direction to the surface, or -1 on miss.
+     */
+    mjtNum RayGeom(const mjtNum* Position, const mjtNum* Orientation,
+                   const mjtNum* Size, const mjtNum* Origin,
+                   const mjtNum* Direction, int GeomType) const;
+
+    /**
+     * @brief Extracts the 6D force:torque of a contact, in the contact frame.
+     * @param Model Pointer to the MuJoCo model.
+     * @param Data Pointer to the simulation data, after the constraint solve.
+     * @param ContactId Index into Data->contact.
+     * @param Result Receives force (normal, tangent1, tangent2) then torque.
+     */
+    void ContactForce(const mjModel* Model, const mjData* Data, int ContactId,
+                      mjtNum Result[6]) const;
+
     // Data & Model Management
 
     /**
@@ -108,6 +343,16 @@ public:
      */
     mjData* CreateData(const mjModel* Model) const;
 
+    /**
+     * @brief Copies simulation data into an existing mjData of the same model.
+     * @param Model Pointer to the MuJoCo model both structures were made for.
+     * @param Source Pointer to the data to copy from.
+     * @param Destination Pointer to the preallocated data to copy into.
+     * @return Destination, or nullptr on failure.
+     */
+    mjData* CopyData(const mjModel* Model, const mjData* Source,
+                     mjData* Destination) const;
+
     /**
      * @brief Frees the allocated mjData structure.
      * @param Data Pointer to the mjData to be freed.
@@ -120,6 +365,19 @@ public:
      */
     void FreeModel(mjModel* Model) const;
 
+    // Error Handling
+
+    /**
+     * @brief Installs the handler MuJoCo calls on fatal errors such as a stack overflow.
+     *
+     * Without one, MuJoCo prints the message and exits the process. The handler is process-wide
+     * and MuJoCo carries on once it returns, so data that raised an error must not be stepped
+     * again.
+     * @param Handler Called with the error message; nullptr restores the default.
+     * @return True if the handler was installed.
+     */
+    bool SetErrorHandler(void (*Handler)(const char*)) const;
+
 private:
     /** Handle to the dynamically loaded MuJoCo shared library. */
     void* MuJoCoHandle;
@@ -134,9 +392,39 @@ private:
     typedef void (*Mj_StepFunc)(const mjModel*, mjData*);
     typedef void (*Mj_ForwardFunc)(const mjModel*, mjData*);
     typedef void (*Mj_ResetDataFunc)(const mjModel*, mjData*);
+    typedef void (*Mj_KinematicsFunc)(const mjModel*, mjData*);
+    typedef int (*Mj_StateSizeFunc)(const mjModel*, unsigned int);
+    typedef void (*Mj_GetStateFunc)(const mjModel*, const mjData*, mjtNum*, unsigned int);
+    typedef void (*Mj_SetStateFunc)(const mjModel*, mjData*, const mjtNum*, unsigned int);
     typedef mjData* (*Mj_MakeDataFunc)(const mjModel*);
+    typedef int (*Mj_Name2IdFunc)(const mjModel*, int, const char*);
+    typedef void (*Mj_MultiRayFunc)(const mjModel*, mjData*, const mjtNum*, const mjtNum*,
+                                    const mjtByte*, mjtByte, int, int*, mjtNum*, int, mjtNum);
+    typedef mjtNum (*Mju_RayGeomFunc)(const mjtNum*, const mjtNum*, const mjtNum*,
+                                      const mjtNum*, const mjtNum*, int);
+    typedef void (*Mj_ContactForceFunc)(const mjModel*, const mjData*, int, mjtNum*);
+    typedef mjData* (*Mj_CopyDataFunc)(mjData*, const mjModel*, const mjData*);
+    typedef mjSpec* (*Mj_MakeSpecFunc)();
+    typedef mjSpec* (*Mj_ParseXMLFunc)(const char*, const mjVFS*, char*, int);
+    typedef const char* (*Mjs_GetErrorFunc)(mjSpec*);
+    typedef mjsBody* (*Mjs_FindBodyFunc)(mjSpec*, const char*);
+    typedef mjsElement* (*Mjs_FirstChildFunc)(mjsBody*, mjtObj, int);
+    typedef mjsElement* (*Mjs_NextChildFunc)(mjsBody*, mjsElement*, int);
+    typedef mjsBody* (*Mjs_AsBodyFunc)(mjsElement*);
+    typedef mjsFrame* (*Mjs_AddFrameFunc)(mjsBody*, mjsFrame*);
+    typedef mjsBody* (*Mjs_AttachBodyFunc)(mjsFrame*, const mjsBody*, const char*, const char*);
+    typedef int (*Mjs_GetIdFunc)(mjsElement*);
+    typedef int (*Mj_RecompileFunc)(mjSpec*, const mjVFS*, mjModel*, mjData*);
+    typedef mjsBody* (*Mjs_AddBodyFunc)(mjsBody*, const mjsDefault*);
+    typedef mjsGeom* (*Mjs_AddGeomFunc)(mjsBody*, const mjsDefault*);
+    typedef mjsJoint* (*Mjs_AddFreeJointFunc)(mjsBody*);
+    typedef int (*Mjs_DetachBodyFunc)(mjSpec*, mjsBody*);
+    typedef mjsElement* (*Mjs_FirstElementFunc)(mjSpec*, mjtObj);
+    typedef mjsElement* (*Mjs_NextElementFunc)(mjSpec*, mjsElement*);
+    typedef void (*Mjs_SetStringFunc)(mjString*, const char*);
     typedef void (*Mj_DeleteDataFunc)(mjData*);
     typedef void (*Mj_DeleteModelFunc)(mjModel*);
+    typedef void (*Mju_ErrorHandlerFunc)(const char*);
 
     /** Function pointers for MuJoCo API calls. */
     Mj_VersionFunc Mj_Version;
@@ -148,7 +436,37 @@ private:
     Mj_StepFunc Mj_Step;
     Mj_ForwardFunc Mj_Forward;
     Mj_ResetDataFunc Mj_ResetData;
+    Mj_KinematicsFunc Mj_Kinematics;
+    Mj_StateSizeFunc Mj_StateSize;
+    Mj_GetStateFunc Mj_GetState;
+    Mj_SetStateFunc Mj_SetState;
     Mj_MakeDataFunc Mj_MakeData;
+    Mj_CopyDataFunc Mj_CopyData;
+    Mj_Name2IdFunc Mj_Name2Id;
+    Mj_MultiRayFunc Mj_MultiRay;
+    Mju_RayGeomFunc Mju_RayGeom;
+    Mj_ContactForceFunc Mj_ContactForce;
+    Mj_MakeSpecFunc Mj_MakeSpec;
+    Mj_ParseXMLFunc Mj_ParseXML;
+    Mjs_GetErrorFunc Mjs_GetError;
+    Mjs_FindBodyFunc Mjs_FindBody;
+    Mjs_FirstChildFunc Mjs_FirstChild;
+    Mjs_NextChildFunc Mjs_NextChild;
+    Mjs_AsBodyFunc Mjs_AsBody;
+    Mjs_AddFrameFunc Mjs_AddFrame;
+    Mjs_AttachBodyFunc Mjs_AttachBody;
+    Mjs_GetIdFunc Mjs_GetId;
+    Mj_RecompileFunc Mj_Recompile;
+    Mjs_AddBodyFunc Mjs_AddBody;
+    Mjs_AddGeomFunc Mjs_AddGeom;
+    Mjs_AddFreeJointFunc Mjs_AddFreeJoint;
+    Mjs_DetachBodyFunc Mjs_DetachBody;
+    Mjs_FirstElementFunc Mjs_FirstElement;
+    Mjs_NextElementFunc Mjs_NextElement;
+    Mjs_SetStringFunc Mjs_SetString;
     Mj_DeleteDataFunc Mj_DeleteData;
     Mj_DeleteModelFunc Mj_DeleteModel;
+
+    /** Address of MuJoCo's mju_user_error variable rather than a function. */
+    Mju_ErrorHandlerFunc* Mju_UserError;
 };
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoPolicyBridge, Log, All);
+
+/**
+ * @brief Layout of the start of the shared segment. The observation block
+ * follows at ObservationOffset and the action block at ActionOffset, both
+ * arrays of little-endian doubles. External processes must mirror this
+ * layout byte for byte; see Plugins/mujoco/Scripts/stand_in_policy.py.
+ */
+struct FMujocoPolicyBridgeHeader {
+    static constexpr uint32 ExpectedMagic = 0x42504A4D;  // "MJPB"
+    static constexpr uint32 ExpectedVersion = 1;
+
+    uint32 Magic;
+    uint32 Version;
+    uint32 NumObservations;
+    uint32 NumActions;
+    uint32 ObservationOffset;
+    uint32 ActionOffset;
+
+    /** Bumped by the simulation after it has written a new observation. */
+    alignas(64) std::atomic<uint64> ObservationSequence;
+
+    /** Set by the policy to the observation sequence its actions answer. */
+    alignas(64) std::atomic<uint64> ActionSequence;
+};
+
+static_assert(std::atomic<uint64>::is_always_lock_free,
+              "The policy handshake needs address-free atomics");
+static_assert(sizeof(FMujocoPolicyBridgeHeader) == 192,
+              "Shared header layout changed; update external policies");
+
+/**
+ * @class FMujocoPolicyBridge
+ * @brief Exchanges observations and actions with an external policy process
+ * through a named shared-memory segment.
+ *
+ * The handshake is a pair of sequence numbers on separate cache lines. The
+ * simulation writes an observation and release-stores a new observation
+ * sequence. The policy spins until it sees it, writes its actions and
+ * release-stores the same value as the action sequence. No locks or system
+ * calls are involved on either side, so a round trip costs a few cache-line
+ * transfers plus the policy's own compute time.
+ */
+class MUJOCO_API FMujocoPolicyBridge {
+public:
+    FMujocoPolicyBridge() = default;
+    ~FMujocoPolicyBridge();
+
+    FMujocoPolicyBridge(const FMujocoPolicyBridge&) = delete;
+    FMujocoPolicyBridge& operator=(const FMujocoPolicyBridge&) = delete;
+
+    /**
+     * @brief Creates (or recreates) the shared segment.
+     * @param Name Segment name without a leading slash, e.g. "mujoco_policy".
+     * @param NumObservations Number of doubles per observation.
+     * @param NumActions Number of doubles per action.
+     * @return True if the segment was mapped.
+     */
+    bool Create(const FString& Name, int32 NumObservations, int32 NumActions);
+
+    /**
+     * @brief Unmaps and removes the segment.
+     */
+    void Close();
+
+    bool IsOpen() const { return Header != nullptr; }
+
+    /**
+     * @brief Observation block to fill in before Publish().
+     */
+    TArrayView<double> GetObservations() const;
+
+    /**
+     * @brief Action block, valid after WaitForActions() returned true.
+     */
+    TArrayView<const double> GetActions() const;
+
+    /**
+     * @brief Makes the current observation visible to the policy.
+     * @return The sequence number to wait on.
+     */
+    uint64 Publish();
+
+    /**
+     * @brief Spins until the policy has answered Sequence.
+     * @param Sequence Value returned by Publish().
+     * @param TimeoutSeconds Give up after this long; the policy may be gone.
+     * @return True if the actions for Sequence are available.
+     */
+    bool WaitForActions(uint64 Sequence, double TimeoutSeconds) const;
+
+    /**
+     * @brief Publishes Observations and waits for the matching actions.
+     * @return True if OutActions was filled with fresh actions.
+     */
+    bool Exchange(TConstArrayView<double> Observations,
+                  TArrayView<double> OutActions, double TimeoutSeconds);
+
+private:
+    FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+    FMujocoPolicyBridgeHeader* Header = nullptr;
+    uint64 NextSequence = 1;
+};
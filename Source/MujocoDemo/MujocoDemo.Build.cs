@@ -6,7 +6,7 @@ public class MujocoDemo : ModuleRules
 {
 	public MujocoDemo(ReadOnlyTargetRules Target) : base(Target)
 	{
-		PrivateDependencyModuleNames.AddRange(new string[] { "GeometryFramework" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "GeometryFramework", "Json", "MeshDescription", "Sockets", "StaticMeshDescription" });
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "mujoco", "GeometryCore", "GeometryFramework" });
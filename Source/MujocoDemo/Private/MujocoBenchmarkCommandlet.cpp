@@ -0,0 +1,271 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoBenchmarkCommandlet.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "MujocoAPI.h"
+#include "MujocoManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoBenchmark);
+
+
+namespace
+{
+	/** Reference models, from the fixed cost of one manager to contact-, joint- and mesh-heavy scenes */
+	const TCHAR* const DefaultModels[] = { TEXT("box"), TEXT("humanoid"), TEXT("pile_1000"), TEXT("mesh_arm") };
+
+	constexpr int32 CompileRepeats = 5;
+	constexpr int32 WarmupSteps = 100;
+
+	struct FBenchmarkResult
+	{
+		/** mj_loadXML alone, median of CompileRepeats */
+		double CompileMs = 0.0;
+
+		/** The manager's whole LoadModel: compile, binding and component creation */
+		double LoadModelMs = 0.0;
+		double StepsPerSecond = 0.0;
+		double SyncMs = 0.0;
+	};
+
+	/** Metric name, whether larger values are better, and its field */
+	struct FMetric
+	{
+		const TCHAR* Name;
+		bool bHigherIsBetter;
+		double FBenchmarkResult::* Field;
+	};
+
+	const FMetric Metrics[] = {
+		{ TEXT("CompileMs"), false, &FBenchmarkResult::CompileMs },
+		{ TEXT("LoadModelMs"), false, &FBenchmarkResult::LoadModelMs },
+		{ TEXT("StepsPerSecond"), true, &FBenchmarkResult::StepsPerSecond },
+		{ TEXT("SyncMs"), false, &FBenchmarkResult::SyncMs },
+	};
+
+	double Median(TArray<double>& Samples)
+	{
+		if (Samples.IsEmpty())
+		{
+			return 0.0;
+		}
+		Samples.Sort();
+		return Samples[Samples.Num() / 2];
+	}
+
+	bool RunModel(const FMujocoAPI& Api, UWorld* World, const FString& XMLPath, const int32 Steps, const int32 Syncs, FBenchmarkResult& OutResult)
+	{
+		// Compile alone, without the manager's binding and components
+		TArray<double> CompileSamples;
+		for (int32 Repeat = 0; Repeat < CompileRepeats; ++Repeat)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			mjModel* Model = Api.LoadModelFromXML(XMLPath);
+			CompileSamples.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+			if (!Model)
+			{
+				UE_LOG(LogMujocoBenchmark, Error, TEXT("Failed to compile %s."), *XMLPath);
+				return false;
+			}
+			Api.FreeModel(Model);
+		}
+		OutResult.CompileMs = Median(CompileSamples);
+
+		AMujocoManager* Manager = World->SpawnActor<AMujocoManager>();
+		Manager->SetMuJoCoXMLPath(XMLPath);
+		double StartTime = FPlatformTime::Seconds();
+		const bool bLoaded = Manager->LoadModel();
+		OutResult.LoadModelMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		if (!bLoaded)
+		{
+			Manager->Destroy();
+			return false;
+		}
+
+		for (int32 Step = 0; Step < WarmupSteps; ++Step)
+		{
+			Manager->StepSimulation();
+		}
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Step = 0; Step < Steps; ++Step)
+		{
+			Manager->StepSimulation();
+		}
+		const double StepSeconds = FPlatformTime::Seconds() - StartTime;
+		OutResult.StepsPerSecond = StepSeconds > 0.0 ? Steps / StepSeconds : 0.0;
+
+		// One step between syncs so every sync moves the components
+		TArray<double> SyncSamples;
+		SyncSamples.Reserve(Syncs);
+		for (int32 Sync = 0; Sync < Syncs; ++Sync)
+		{
+			Manager->StepSimulation();
+			StartTime = FPlatformTime::Seconds();
+			Manager->UpdateMuJoCoObjects();
+			SyncSamples.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+		OutResult.SyncMs = Median(SyncSamples);
+
+		Manager->Destroy();
+		return true;
+	}
+
+	TSharedRef<FJsonObject> ResultToJson(const FBenchmarkResult& Result)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		for (const FMetric& Metric : Metrics)
+		{
+			Object->SetNumberField(Metric.Name, Result.*Metric.Field);
+		}
+		return Object;
+	}
+
+	bool WriteJson(const TSharedRef<FJsonObject>& Object, const FString& Path)
+	{
+		FString Text;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+		return FJsonSerializer::Serialize(Object, Writer) && FFileHelper::SaveStringToFile(Text, *Path);
+	}
+}
+
+
+UMujocoBenchmarkCommandlet::UMujocoBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UMujocoBenchmarkCommandlet::Main(const FString& Params)
+{
+	const FString BenchmarkDir = FPaths::Combine(FPaths::ProjectPluginsDir(), TEXT("mujoco"), TEXT("Resources"), TEXT("Benchmarks"));
+
+	FString BaselinesPath = FPaths::Combine(BenchmarkDir, TEXT("Baselines.json"));
+	FParse::Value(*Params, TEXT("Baselines="), BaselinesPath);
+	int32 Steps = 2000;
+	FParse::Value(*Params, TEXT("Steps="), Steps);
+	int32 Syncs = 200;
+	FParse::Value(*Params, TEXT("Syncs="), Syncs);
+	const bool bUpdateBaselines = FParse::Param(*Params, TEXT("UpdateBaselines"));
+
+	TArray<FString> Models;
+	FString ModelList;
+	if (FParse::Value(*Params, TEXT("Models="), ModelList, false))
+	{
+		ModelList.ParseIntoArray(Models, TEXT(","));
+	}
+	else
+	{
+		Models.Append(DefaultModels, UE_ARRAY_COUNT(DefaultModels));
+	}
+
+	// A metric without a baseline fails the check; record them first with -UpdateBaselines
+	TSharedPtr<FJsonObject> Baselines;
+	FString BaselinesText;
+	if (FFileHelper::LoadFileToString(BaselinesText, *BaselinesPath))
+	{
+		FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselinesText), Baselines);
+	}
+	if (!Baselines.IsValid())
+	{
+		UE_LOG(LogMujocoBenchmark, Warning, TEXT("No baselines at %s."), *BaselinesPath);
+		Baselines = MakeShared<FJsonObject>();
+	}
+	const TSharedPtr<FJsonObject>* Tolerances = nullptr;
+	Baselines->TryGetObjectField(TEXT("Tolerances"), Tolerances);
+	const TSharedPtr<FJsonObject>* BaselineResults = nullptr;
+	Baselines->TryGetObjectField(TEXT("Results"), BaselineResults);
+
+	FMujocoAPI Api;
+	if (!Api.LoadMuJoCo())
+	{
+		UE_LOG(LogMujocoBenchmark, Error, TEXT("Failed to load the MuJoCo library."));
+		return 1;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("MujocoBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+
+	TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	int32 Failures = 0;
+	int32 Regressions = 0;
+	int32 Unchecked = 0;
+	for (const FString& Name : Models)
+	{
+		FBenchmarkResult Result;
+		if (!RunModel(Api, World, FPaths::Combine(BenchmarkDir, Name + TEXT(".xml")), Steps, Syncs, Result))
+		{
+			++Failures;
+			continue;
+		}
+		Results->SetObjectField(Name, ResultToJson(Result));
+
+		const TSharedPtr<FJsonObject>* Baseline = nullptr;
+		const bool bHasBaseline = BaselineResults && (*BaselineResults)->TryGetObjectField(Name, Baseline);
+		for (const FMetric& Metric : Metrics)
+		{
+			const double Value = Result.*Metric.Field;
+			double Reference = 0.0;
+			double Tolerance = 0.0;
+			if (!bHasBaseline || !(*Baseline)->TryGetNumberField(Metric.Name, Reference) || Reference <= 0.0)
+			{
+				UE_LOG(LogMujocoBenchmark, Display, TEXT("%-10s %-15s %12.3f  NO BASELINE"), *Name, Metric.Name, Value);
+				++Unchecked;
+				continue;
+			}
+			if (Tolerances)
+			{
+				(*Tolerances)->TryGetNumberField(Metric.Name, Tolerance);
+			}
+
+			const double Change = (Value - Reference) / Reference;
+			const bool bRegressed = Metric.bHigherIsBetter ? Change < -Tolerance : Change > Tolerance;
+			Regressions += bRegressed;
+			UE_LOG(LogMujocoBenchmark, Display, TEXT("%-10s %-15s %12.3f  baseline %12.3f  %+6.1f%% (tolerance %.0f%%)%s"),
+				*Name, Metric.Name, Value, Reference, Change * 100.0, Tolerance * 100.0, bRegressed ? TEXT("  REGRESSED") : TEXT(""));
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	const FString RunPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), FString::Printf(TEXT("MujocoBenchmark-%s.json"), *FDateTime::Now().ToString()));
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(RunPath), true);
+	if (WriteJson(Results, RunPath))
+	{
+		UE_LOG(LogMujocoBenchmark, Display, TEXT("Wrote results to %s."), *RunPath);
+	}
+
+	if (bUpdateBaselines)
+	{
+		// Only the models of this run are replaced; the others keep their baselines
+		const TSharedRef<FJsonObject> Merged = MakeShared<FJsonObject>();
+		if (BaselineResults)
+		{
+			Merged->Values = (*BaselineResults)->Values;
+		}
+		for (const auto& Result : Results->Values)
+		{
+			Merged->SetField(Result.Key, Result.Value);
+		}
+		Baselines->SetObjectField(TEXT("Results"), Merged);
+		if (WriteJson(Baselines.ToSharedRef(), BaselinesPath))
+		{
+			UE_LOG(LogMujocoBenchmark, Display, TEXT("Updated baselines at %s."), *BaselinesPath);
+		}
+		return Failures > 0 ? 1 : 0;
+	}
+
+	UE_LOG(LogMujocoBenchmark, Display, TEXT("%d models, %d failed to load, %d regressed metrics, %d metrics without a baseline."), Models.Num(), Failures, Regressions, Unchecked);
+	return Failures + Regressions + Unchecked > 0 ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoContacts.h"
+
+#include "MujocoAPI.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoContacts);
+
+
+namespace
+{
+	FString GetBodyName(const mjModel* Model, const int32 Body)
+	{
+		return Model && Body >= 0 && Body < Model->nbody ? FString(UTF8_TO_TCHAR(Model->names + Model->name_bodyadr[Body])) : FString();
+	}
+}
+
+
+void FMujocoContactQuery::Bind(const mjModel* InModel)
+{
+	Reset();
+	Model = InModel;
+	BodyNormalForces.SetNumZeroed(Model ? Model->nbody : 0);
+
+	for (FPairFilter& Filter : PairFilters)
+	{
+		Filter.BodyA = ResolveBody(Model, Filter.BodyA, Filter.NameA, Filter.bUnnamedIds);
+		Filter.BodyB = ResolveBody(Model, Filter.BodyB, Filter.NameB, Filter.bUnnamedIds);
+		if (Filter.bUnnamedIds && Model)
+		{
+			// From here on the filter follows its bodies by name like any other
+			Filter.NameA = GetBodyName(Model, Filter.BodyA);
+			Filter.NameB = GetBodyName(Model, Filter.BodyB);
+			Filter.bUnnamedIds = false;
+		}
+		if (Filter.BodyA == UnresolvedBody || Filter.BodyB == UnresolvedBody)
+		{
+			UE_LOG(LogMujocoContacts, Warning, TEXT("Contact filter '%s' - '%s' refers to a body not in the model; it matches nothing."),
+				*Filter.NameA, Filter.NameB.IsEmpty() ? TEXT("any") : *Filter.NameB);
+		}
+	}
+}
+
+int32 FMujocoContactQuery::ResolveBody(const mjModel* Model, const int32 Id, const FString& Name, const bool bUnnamedIds)
+{
+	if (Id == INDEX_NONE && Name.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+	if (!Model)
+	{
+		return Id;
+	}
+	if (Name.IsEmpty())
+	{
+		return bUnnamedIds && Id >= 0 && Id < Model->nbody ? Id : UnresolvedBody;
+	}
+
+	// Names are case-sensitive in MuJoCo
+	const FTCHARToUTF8 Utf8Name(*Name);
+	for (int32 Body = 0; Body < Model->nbody; ++Body)
+	{
+		if (FCStringAnsi::Strcmp(Model->names + Model->name_bodyadr[Body], Utf8Name.Get()) == 0)
+		{
+			return Body;
+		}
+	}
+	return UnresolvedBody;
+}
+
+void FMujocoContactQuery::Reset()
+{
+	Model = nullptr;
+	Contacts.Reset();
+	BodyNormalForces.Reset();
+	for (FMujocoContactPairStats& Stats : PairStats)
+	{
+		Stats = FMujocoContactPairStats();
+	}
+}
+
+int32 FMujocoContactQuery::AddPairFilter(const int32 BodyA, const int32 BodyB)
+{
+	FPairFilter Filter{BodyA, BodyB, GetBodyName(Model, BodyA), GetBodyName(Model, BodyB), Model == nullptr};
+	PairStats.AddDefaulted();
+	return PairFilters.Add(MoveTemp(Filter));
+}
+
+void FMujocoContactQuery::ClearPairFilters()
+{
+	PairFilters.Reset();
+	PairStats.Reset();
+}
+
+void FMujocoContactQuery::Extract(const FMujocoAPI& Api, const mjModel* Model, const mjData* Data)
+{
+	Contacts.Reset();
+	FMemory::Memzero(BodyNormalForces.GetData(), BodyNormalForces.Num() * sizeof(double));
+	for (FMujocoContactPairStats& Stats : PairStats)
+	{
+		Stats = FMujocoContactPairStats();
+	}
+
+	if (!Model || !Data)
+	{
+		return;
+	}
+
+	// Reset() keeps the allocation, so this only grows on a new peak
+	Contacts.SetNumUninitialized(Data->ncon);
+	int32 NumContacts = 0;
+
+	for (int32 Index = 0; Index < Data->ncon; ++Index)
+	{
+		const mjContact& Source = Data->contact[Index];
+
+		// Contacts excluded from the constraint problem carry no force
+		if (Source.exclude != 0)
+		{
+			continue;
+		}
+
+		FMujocoContact& Contact = Contacts[NumContacts++];
+		Contact.Geom1 = Source.geom[0];
+		Contact.Geom2 = Source.geom[1];
+		Contact.Body1 = Contact.Geom1 >= 0 ? Model->geom_bodyid[Contact.Geom1] : INDEX_NONE;
+		Contact.Body2 = Contact.Geom2 >= 0 ? Model->geom_bodyid[Contact.Geom2] : INDEX_NONE;
+		Contact.Position = FVector(Source.pos[0], Source.pos[1], Source.pos[2]);
+		Contact.Normal = FVector(Source.frame[0], Source.frame[1], Source.frame[2]);
+		Contact.Distance = Source.dist;
+
+		// Force comes back in the contact frame, whose rows are the normal and two tangents
+		mjtNum Wrench[6];
+		Api.ContactForce(Model, Data, Index, Wrench);
+		const mjtNum* Frame = Source.frame;
+		Contact.NormalForce = Wrench[0];
+		Contact.Force = FVector(
+			Frame[0] * Wrench[0] + Frame[3] * Wrench[1] + Frame[6] * Wrench[2],
+			Frame[1] * Wrench[0] + Frame[4] * Wrench[1] + Frame[7] * Wrench[2],
+			Frame[2] * Wrench[0] + Frame[5] * Wrench[1] + Frame[8] * Wrench[2]);
+
+		if (Contact.Body1 >= 0)
+		{
+			BodyNormalForces[Contact.Body1] += Contact.NormalForce;
+		}
+		if (Contact.Body2 >= 0 && Contact.Body2 != Contact.Body1)
+		{
+			BodyNormalForces[Contact.Body2] += Contact.NormalForce;
+		}
+
+		for (int32 Filter = 0; Filter < PairFilters.Num(); ++Filter)
+		{
+			if (Matches(PairFilters[Filter], Contact.Body1, Contact.Body2))
+			{
+				++PairStats[Filter].NumContacts;
+				PairStats[Filter].NormalForce += Contact.NormalForce;
+			}
+		}
+	}
+
+	Contacts.SetNum(NumContacts, EAllowShrinking::No);
+}
+
+const FMujocoContactPairStats& FMujocoContactQuery::GetPairStats(const int32 Filter) const
+{
+	static const FMujocoContactPairStats Empty;
+	return PairStats.IsValidIndex(Filter) ? PairStats[Filter] : Empty;
+}
+
+void FMujocoContactQuery::FindContacts(const int32 BodyA, const int32 BodyB, TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset();
+	const FPairFilter Filter{BodyA, BodyB};
+	for (int32 Index = 0; Index < Contacts.Num(); ++Index)
+	{
+		if (Matches(Filter, Contacts[Index].Body1, Contacts[Index].Body2))
+		{
+			OutIndices.Add(Index);
+		}
+	}
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoControlBuffer.h"
+
+
+void FMujocoControlBuffer::Initialize(const mjModel* Model, const mjData* Data)
+{
+	Release();
+	if (!Model || !Data || Model->nu == 0)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	Staged.SetNumUninitialized(Model->nu);
+	FMemory::Memcpy(Staged.GetData(), Data->ctrl, Model->nu * sizeof(double));
+	From = Staged;
+	Target = Staged;
+	TickTime = Data->time;
+	bDirty = false;
+}
+
+void FMujocoControlBuffer::Release()
+{
+	FScopeLock ScopeLock(&Lock);
+	Staged.Empty();
+	From.Empty();
+	Target.Empty();
+	bDirty = false;
+}
+
+void FMujocoControlBuffer::SetControls(const TConstArrayView<double> Values, const int32 FirstActuator)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (FirstActuator < 0 || FirstActuator >= Staged.Num())
+	{
+		return;
+	}
+
+	// Sources that restage the same values every step must not restart the ramp
+	const int32 Count = FMath::Min(Values.Num(), Staged.Num() - FirstActuator);
+	if (FMemory::Memcmp(Staged.GetData() + FirstActuator, Values.GetData(), Count * sizeof(double)) != 0)
+	{
+		FMemory::Memcpy(Staged.GetData() + FirstActuator, Values.GetData(), Count * sizeof(double));
+		bDirty = true;
+	}
+}
+
+void FMujocoControlBuffer::SetControl(const int32 Actuator, const double Value)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (Staged.IsValidIndex(Actuator) && Staged[Actuator] != Value)
+	{
+		Staged[Actuator] = Value;
+		bDirty = true;
+	}
+}
+
+void FMujocoControlBuffer::GetStagedControls(TArray<double>& OutValues) const
+{
+	FScopeLock ScopeLock(&Lock);
+	OutValues.Reset(Staged.Num());
+	OutValues.Append(Staged);
+}
+
+void FMujocoControlBuffer::Reset(const mjData* Data)
+{
+	if (!Data || !IsInitialized())
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	FMemory::Memcpy(Staged.GetData(), Data->ctrl, Staged.Num() * sizeof(double));
+	From = Staged;
+	Target = Staged;
+	TickTime = Data->time;
+	bDirty = false;
+}
+
+void FMujocoControlBuffer::Apply(mjData* Data)
+{
+	if (!Data || !IsInitialized())
+	{
+		return;
+	}
+
+	const int32 NumActuators = Target.Num();
+	{
+		FScopeLock ScopeLock(&Lock);
+		// Staging may have changed and changed back since the last step; then the current ramp carries on
+		if (bDirty && FMemory::Memcmp(Target.GetData(), Staged.GetData(), NumActuators * sizeof(double)) != 0)
+		{
+			// Ramp from what was actually applied last, so a tick arriving mid-ramp stays continuous
+			FMemory::Memcpy(From.GetData(), Data->ctrl, NumActuators * sizeof(double));
+			FMemory::Memcpy(Target.GetData(), Staged.GetData(), NumActuators * sizeof(double));
+			TickTime = Data->time;
+		}
+		bDirty = false;
+	}
+
+	const double Alpha = InterpolationTime > 0.0 ? FMath::Clamp((Data->time - TickTime) / InterpolationTime, 0.0, 1.0) : 1.0;
+	if (Alpha >= 1.0)
+	{
+		FMemory::Memcpy(Data->ctrl, Target.GetData(), NumActuators * sizeof(double));
+		return;
+	}
+
+	for (int32 i = 0; i < NumActuators; ++i)
+	{
+		Data->ctrl[i] = From[i] + (Target[i] - From[i]) * Alpha;
+	}
+}
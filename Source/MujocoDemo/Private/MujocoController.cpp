@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoController.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoController);
+
+
+namespace
+{
+	/** MuJoCo names are case-sensitive, unlike FString's default map keys */
+	template <typename ValueType>
+	struct TCaseSensitiveNameKeyFuncs : TDefaultMapKeyFuncs<FString, ValueType, false>
+	{
+		static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+	};
+
+	using FPDSettings = TPair<FMujocoPDGains, double>;
+}
+
+
+bool FMujocoJointPDController::Bind(const mjModel* Model)
+{
+	// Settings of the previous binding by joint name, carried over to actuators driving the same joint
+	TMap<FString, FPDSettings, FDefaultSetAllocator, TCaseSensitiveNameKeyFuncs<FPDSettings>> Previous;
+	for (int32 Actuator = 0; Actuator < JointNames.Num(); ++Actuator)
+	{
+		if (!JointNames[Actuator].IsEmpty())
+		{
+			Previous.Add(JointNames[Actuator], { Gains[Actuator], Targets[Actuator] });
+		}
+	}
+
+	Unbind();
+	if (!Model)
+	{
+		return false;
+	}
+
+	Gains.SetNum(Model->nu);
+	Targets.SetNumZeroed(Model->nu);
+	QposAddresses.Init(INDEX_NONE, Model->nu);
+	DofAddresses.Init(INDEX_NONE, Model->nu);
+	JointNames.SetNum(Model->nu);
+
+	int32 NumSupported = 0;
+	for (int32 Actuator = 0; Actuator < Model->nu; ++Actuator)
+	{
+		if (Model->actuator_trntype[Actuator] != mjTRN_JOINT)
+		{
+			continue;
+		}
+
+		const int32 Joint = Model->actuator_trnid[Actuator * 2];
+		const int32 JointType = Model->jnt_type[Joint];
+		if (JointType != mjJNT_HINGE && JointType != mjJNT_SLIDE)
+		{
+			continue;
+		}
+
+		QposAddresses[Actuator] = Model->jnt_qposadr[Joint];
+		DofAddresses[Actuator] = Model->jnt_dofadr[Joint];
+		JointNames[Actuator] = UTF8_TO_TCHAR(Model->names + Model->name_jntadr[Joint]);
+		++NumSupported;
+
+		FPDSettings Settings;
+		if (!JointNames[Actuator].IsEmpty() && Previous.RemoveAndCopyValue(JointNames[Actuator], Settings))
+		{
+			Gains[Actuator] = Settings.Key;
+			Targets[Actuator] = Settings.Value;
+		}
+	}
+
+	for (const auto& Dropped : Previous)
+	{
+		if (Dropped.Value.Key.Kp != 0.0 || Dropped.Value.Key.Kd != 0.0)
+		{
+			UE_LOG(LogMujocoController, Warning, TEXT("Joint '%s' is no longer driven by an actuator; its PD gains were dropped."), *Dropped.Key);
+		}
+	}
+
+	UE_LOG(LogMujocoController, Log, TEXT("PD controller bound to %d of %d actuators"), NumSupported, Model->nu);
+	return NumSupported > 0;
+}
+
+void FMujocoJointPDController::Unbind()
+{
+	Gains.Reset();
+	Targets.Reset();
+	QposAddresses.Reset();
+	DofAddresses.Reset();
+	JointNames.Reset();
+}
+
+void FMujocoJointPDController::SetGains(const int32 Actuator, const FMujocoPDGains& InGains)
+{
+	if (Gains.IsValidIndex(Actuator))
+	{
+		Gains[Actuator] = InGains;
+	}
+}
+
+void FMujocoJointPDController::SetAllGains(const FMujocoPDGains& InGains)
+{
+	for (int32 Actuator = 0; Actuator < Gains.Num(); ++Actuator)
+	{
+		if (DofAddresses[Actuator] != INDEX_NONE)
+		{
+			Gains[Actuator] = InGains;
+		}
+	}
+}
+
+void FMujocoJointPDController::SetTarget(const int32 Actuator, const double Target)
+{
+	if (Targets.IsValidIndex(Actuator))
+	{
+		Targets[Actuator] = Target;
+	}
+}
+
+void FMujocoJointPDController::SetTargets(const TConstArrayView<double> InTargets, const int32 FirstActuator)
+{
+	if (FirstActuator < 0 || FirstActuator >= Targets.Num())
+	{
+		return;
+	}
+
+	const int32 Count = FMath::Min(InTargets.Num(), Targets.Num() - FirstActuator);
+	FMemory::Memcpy(Targets.GetData() + FirstActuator, InTargets.GetData(), Count * sizeof(double));
+}
+
+void FMujocoPDPositionController::Compute(const mjModel* Model, mjData* Data)
+{
+	const int32 NumActuators = FMath::Min(Targets.Num(), Model->nu);
+	for (int32 Actuator = 0; Actuator < NumActuators; ++Actuator)
+	{
+		const FMujocoPDGains& Gain = Gains[Actuator];
+		const int32 Dof = DofAddresses[Actuator];
+		if (Dof == INDEX_NONE || (Gain.Kp == 0.0 && Gain.Kd == 0.0))
+		{
+			continue;
+		}
+
+		const double Position = Data->qpos[QposAddresses[Actuator]];
+		const double Velocity = Data->qvel[Dof];
+		Data->ctrl[Actuator] = Gain.Kp * (Targets[Actuator] - Position) - Gain.Kd * Velocity;
+	}
+}
+
+bool FMujocoPDVelocityController::Bind(const mjModel* Model)
+{
+	const bool bBound = FMujocoJointPDController::Bind(Model);
+	PreviousErrors.SetNumZeroed(Model ? Model->nu : 0);
+	PreviousTime = -1.0;
+	return bBound;
+}
+
+void FMujocoPDVelocityController::Compute(const mjModel* Model, mjData* Data)
+{
+	// No derivative on the first step, or after the clock jumped back through a reset or rewind
+	const double Elapsed = PreviousTime >= 0.0 ? Data->time - PreviousTime : 0.0;
+	const double InvElapsed = Elapsed > 0.0 ? 1.0 / Elapsed : 0.0;
+	PreviousTime = Data->time;
+
+	const int32 NumActuators = FMath::Min(Targets.Num(), Model->nu);
+	for (int32 Actuator = 0; Actuator < NumActuators; ++Actuator)
+	{
+		const FMujocoPDGains& Gain = Gains[Actuator];
+		const int32 Dof = DofAddresses[Actuator];
+		if (Dof == INDEX_NONE || (Gain.Kp == 0.0 && Gain.Kd == 0.0))
+		{
+			continue;
+		}
+
+		const double Error = Targets[Actuator] - Data->qvel[Dof];
+		const double ErrorRate = (Error - PreviousErrors[Actuator]) * InvElapsed;
+		PreviousErrors[Actuator] = Error;
+		Data->ctrl[Actuator] = Gain.Kp * Error + Gain.Kd * ErrorRate;
+	}
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoConversion.h"
+
+
+FVector FMujocoConversion::ToUnrealPosition(const mjtNum* Position) const
+{
+	return Dispatch([this, Position](auto Convention) { return MujocoConversion::ToUnrealPosition<decltype(Convention)>(Position, UnitScale); });
+}
+
+FVector FMujocoConversion::ToUnrealPosition(const FVector& Position) const
+{
+	return Dispatch([this, &Position](auto Convention) { return MujocoConversion::ToUnrealPosition<decltype(Convention)>(Position, UnitScale); });
+}
+
+FVector FMujocoConversion::ToUnrealDirection(const FVector& Direction) const
+{
+	return Dispatch([&Direction](auto Convention) { return MujocoConversion::ToUnrealPosition<decltype(Convention)>(Direction, 1.0); });
+}
+
+FQuat FMujocoConversion::ToUnrealRotation(const FQuat& Rotation) const
+{
+	return Dispatch([&Rotation](auto Convention) { return MujocoConversion::ToUnrealRotation<decltype(Convention)>(Rotation); });
+}
+
+FVector FMujocoConversion::ToMujocoPosition(const FVector& Position) const
+{
+	return Dispatch([this, &Position](auto Convention) { return MujocoConversion::ToMujocoPosition<decltype(Convention)>(Position, UnitScale); });
+}
+
+FQuat FMujocoConversion::ToMujocoRotation(const FQuat& Rotation) const
+{
+	return Dispatch([&Rotation](auto Convention) { return MujocoConversion::ToMujocoRotation<decltype(Convention)>(Rotation); });
+}
@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoDataPool.h"
+
+#include "MujocoAPI.h"
+#include "Misc/ScopeLock.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoDataPool);
+
+
+FMujocoDataPool::FMujocoDataPool(std::shared_ptr<FMujocoAPI> InApi)
+	: Api(MoveTemp(InApi))
+{
+}
+
+FMujocoDataPool::~FMujocoDataPool()
+{
+	FScopeLock ScopeLock(&Lock);
+	for (auto& PoolPair : Pools)
+	{
+		if (PoolPair.Value.Outstanding > 0)
+		{
+			UE_LOG(LogMujocoDataPool, Warning, TEXT("%d mjData instances were never returned to the pool."), PoolPair.Value.Outstanding);
+		}
+
+		for (mjData* Data : PoolPair.Value.Free)
+		{
+			Api->FreeData(Data);
+		}
+	}
+	Pools.Empty();
+	Generations.Empty();
+	Owners.Empty();
+}
+
+FMujocoDataPool::FPoolKey FMujocoDataPool::FindOrAddKey(const mjModel* Model)
+{
+	uint64& Generation = Generations.FindOrAdd(Model, 0);
+	if (Generation == 0)
+	{
+		Generation = NextGeneration++;
+	}
+	return FPoolKey(Model, Generation);
+}
+
+mjData* FMujocoDataPool::Acquire(const mjModel* Model, const bool bReset)
+{
+	if (!Model)
+	{
+		return nullptr;
+	}
+
+	mjData* Data = nullptr;
+	FPoolKey Key;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Key = FindOrAddKey(Model);
+		FModelPool& Pool = Pools.FindOrAdd(Key);
+		++Pool.Outstanding;
+
+		if (!Pool.Free.IsEmpty())
+		{
+			Data = Pool.Free.Pop(EAllowShrinking::No);
+			Owners.Add(Data, Key);
+			++Hits;
+		}
+		else
+		{
+			++Misses;
+		}
+	}
+
+	if (!Data)
+	{
+		// Allocate outside the lock, mj_makeData zeroes the whole arena
+		Data = Api->CreateData(Model);
+		FScopeLock ScopeLock(&Lock);
+		if (!Data)
+		{
+			UE_LOG(LogMujocoDataPool, Error, TEXT("Failed to allocate mjData."));
+			if (FModelPool* Pool = Pools.Find(Key))
+			{
+				--Pool->Outstanding;
+			}
+			return nullptr;
+		}
+		Owners.Add(Data, Key);
+	}
+	else if (bReset)
+	{
+		Api->ResetData(Model, Data);
+	}
+
+	return Data;
+}
+
+void FMujocoDataPool::Release(const mjModel* Model, mjData* Data)
+{
+	if (!Model || !Data)
+	{
+		return;
+	}
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		FPoolKey Key;
+		if (!Owners.RemoveAndCopyValue(Data, Key) || Key.Get<0>() != Model)
+		{
+			UE_LOG(LogMujocoDataPool, Warning, TEXT("Released an mjData that was not acquired for this model; freeing it."));
+		}
+		else if (FModelPool* Pool = Pools.Find(Key))
+		{
+			--Pool->Outstanding;
+			if (!Pool->bReleased)
+			{
+				Pool->Free.Add(Data);
+				return;
+			}
+
+			if (Pool->Outstanding <= 0)
+			{
+				Pools.Remove(Key);
+			}
+		}
+	}
+
+	// The model was released while this instance was out
+	Api->FreeData(Data);
+}
+
+void FMujocoDataPool::ReleaseModel(const mjModel* Model)
+{
+	TArray<mjData*> ToFree;
+	{
+		FScopeLock ScopeLock(&Lock);
+		uint64 Generation = 0;
+		if (!Generations.RemoveAndCopyValue(Model, Generation))
+		{
+			return;
+		}
+
+		// The next model at this address gets a new generation; instances still out come back to this one
+		const FPoolKey Key(Model, Generation);
+		FModelPool* Pool = Pools.Find(Key);
+		if (!Pool)
+		{
+			return;
+		}
+
+		ToFree = MoveTemp(Pool->Free);
+		if (Pool->Outstanding > 0)
+		{
+			Pool->bReleased = true;
+		}
+		else
+		{
+			Pools.Remove(Key);
+		}
+	}
+
+	for (mjData* Data : ToFree)
+	{
+		Api->FreeData(Data);
+	}
+}
+
+void FMujocoDataPool::Trim(const mjModel* Model)
+{
+	TArray<mjData*> ToFree;
+	{
+		FScopeLock ScopeLock(&Lock);
+		const uint64* Generation = Generations.Find(Model);
+		if (FModelPool* Pool = Generation ? Pools.Find(FPoolKey(Model, *Generation)) : nullptr)
+		{
+			ToFree = MoveTemp(Pool->Free);
+		}
+	}
+
+	for (mjData* Data : ToFree)
+	{
+		Api->FreeData(Data);
+	}
+}
+
+uint64 FMujocoDataPool::GetHits() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Hits;
+}
+
+uint64 FMujocoDataPool::GetMisses() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Misses;
+}
+
+double FMujocoDataPool::GetHitRate() const
+{
+	FScopeLock ScopeLock(&Lock);
+	const uint64 Total = Hits + Misses;
+	return Total > 0 ? static_cast<double>(Hits) / static_cast<double>(Total) : 0.0;
+}
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoDebugDraw.h"
+
+#include "MujocoContacts.h"
+
+
+namespace
+{
+	const FLinearColor ContactColor(1.0f, 0.85f, 0.0f);
+	const FLinearColor ForceColor(1.0f, 0.2f, 0.1f);
+	const FLinearColor CenterOfMassColor(0.2f, 0.6f, 1.0f);
+	const FLinearColor JointAxisColor(0.2f, 1.0f, 0.3f);
+
+	/** Lines each item of a category costs */
+	constexpr int32 LinesPerCross = 3;
+	constexpr int32 LinesPerArrow = 3;
+	constexpr int32 LinesPerAxis = 1;
+
+	/** Stride that fits NumItems items of LinesPerItem lines into Budget lines */
+	int32 GetStride(const int32 NumItems, const int32 LinesPerItem, const int32 Budget)
+	{
+		const int32 MaxItems = FMath::Max(Budget / LinesPerItem, 1);
+		return NumItems > MaxItems ? FMath::DivideAndRoundUp(NumItems, MaxItems) : 1;
+	}
+}
+
+
+void FMujocoDebugDraw::Build(const mjModel* Model, const mjData* Data, const FMujocoContactQuery* Contacts, const FMujocoDebugDrawOptions& Options)
+{
+	Lines.Reset();
+	NumSkipped = 0;
+	if (!Model || !Data)
+	{
+		return;
+	}
+
+	// Split the budget between the enabled categories, contacts first since they are usually why this is on
+	const TArrayView<const FMujocoContact> ContactList = Contacts ? Contacts->GetContacts() : TArrayView<const FMujocoContact>();
+	const int32 LinesPerContact = (Options.bContacts ? LinesPerCross : 0) + (Options.bContactForces ? LinesPerArrow : 0);
+	const int32 NumBodies = Options.bCentersOfMass ? Model->nbody - 1 : 0;
+	const int32 NumJoints = Options.bJointAxes ? Model->njnt : 0;
+
+	const int32 Wanted = ContactList.Num() * LinesPerContact + NumBodies * LinesPerCross + NumJoints * LinesPerAxis;
+	const double Share = Wanted > Options.MaxLines ? static_cast<double>(Options.MaxLines) / Wanted : 1.0;
+	Lines.Reserve(FMath::Min(Wanted, Options.MaxLines));
+
+	if (LinesPerContact > 0)
+	{
+		const int32 Budget = static_cast<int32>(ContactList.Num() * LinesPerContact * Share);
+		const int32 Stride = GetStride(ContactList.Num(), LinesPerContact, Budget);
+		for (int32 Index = 0; Index < ContactList.Num(); Index += Stride)
+		{
+			const FMujocoContact& Contact = ContactList[Index];
+			const FVector Position = Options.Conversion.ToUnrealPosition(Contact.Position);
+			if (Options.bContacts)
+			{
+				AddCross(Position, Options.MarkerSize, ContactColor, Options.Thickness);
+			}
+
+			if (Options.bContactForces && !Contact.Force.IsNearlyZero())
+			{
+				const FVector Force = Options.Conversion.ToUnrealDirection(Contact.Force);
+				const FVector Tip = Position + Force * Options.ForceScale;
+				const FVector Direction = Force.GetSafeNormal();
+				const FVector Side = FVector::CrossProduct(Direction, FMath::Abs(Direction.Z) < 0.9 ? FVector::UpVector : FVector::ForwardVector).GetSafeNormal();
+				const double HeadSize = FMath::Min(Options.MarkerSize * 2.0, (Tip - Position).Size() * 0.3);
+				AddLine(Position, Tip, ForceColor, Options.Thickness);
+				AddLine(Tip, Tip - (Direction - Side * 0.5) * HeadSize, ForceColor, Options.Thickness);
+				AddLine(Tip, Tip - (Direction + Side * 0.5) * HeadSize, ForceColor, Options.Thickness);
+			}
+		}
+		NumSkipped += ContactList.Num() - FMath::DivideAndRoundUp(ContactList.Num(), Stride);
+	}
+
+	if (NumBodies > 0)
+	{
+		const int32 Stride = GetStride(NumBodies, LinesPerCross, static_cast<int32>(NumBodies * LinesPerCross * Share));
+		for (int32 Body = 1; Body < Model->nbody; Body += Stride)
+		{
+			AddCross(Options.Conversion.ToUnrealPosition(Data->xipos + Body * 3), Options.MarkerSize, CenterOfMassColor, Options.Thickness);
+		}
+		NumSkipped += NumBodies - FMath::DivideAndRoundUp(NumBodies, Stride);
+	}
+
+	if (NumJoints > 0)
+	{
+		const int32 Stride = GetStride(NumJoints, LinesPerAxis, static_cast<int32>(NumJoints * LinesPerAxis * Share));
+		for (int32 Joint = 0; Joint < Model->njnt; Joint += Stride)
+		{
+			// Free and ball joints have no single axis
+			const int32 Type = Model->jnt_type[Joint];
+			if (Type != mjJNT_HINGE && Type != mjJNT_SLIDE)
+			{
+				continue;
+			}
+
+			const FVector Anchor = Options.Conversion.ToUnrealPosition(Data->xanchor + Joint * 3);
+			const FVector Axis = Options.Conversion.ToUnrealDirection(FVector(Data->xaxis[Joint * 3], Data->xaxis[Joint * 3 + 1], Data->xaxis[Joint * 3 + 2]));
+			AddLine(Anchor, Anchor + Axis * Options.AxisLength, JointAxisColor, Options.Thickness);
+		}
+		NumSkipped += NumJoints - FMath::DivideAndRoundUp(NumJoints, Stride);
+	}
+}
+
+void FMujocoDebugDraw::Submit(ULineBatchComponent* LineBatcher)
+{
+	if (!LineBatcher)
+	{
+		return;
+	}
+
+	LineBatcher->Flush();
+	if (!Lines.IsEmpty())
+	{
+		LineBatcher->DrawLines(Lines);
+	}
+}
+
+void FMujocoDebugDraw::AddLine(const FVector& Start, const FVector& End, const FLinearColor& Color, const float Thickness)
+{
+	// Zero lifetime: lines live until the next Flush
+	Lines.Emplace(Start, End, Color, 0.0f, Thickness, SDPG_Foreground);
+}
+
+void FMujocoDebugDraw::AddCross(const FVector& Center, const double HalfSize, const FLinearColor& Color, const float Thickness)
+{
+	AddLine(Center - FVector(HalfSize, 0, 0), Center + FVector(HalfSize, 0, 0), Color, Thickness);
+	AddLine(Center - FVector(0, HalfSize, 0), Center + FVector(0, HalfSize, 0), Color, Thickness);
+	AddLine(Center - FVector(0, 0, HalfSize), Center + FVector(0, 0, HalfSize), Color, Thickness);
+}
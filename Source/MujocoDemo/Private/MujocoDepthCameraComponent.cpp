@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoDepthCameraComponent.h"
+
+#include "MujocoAPI.h"
+#include "MujocoManager.h"
+#include "MujocoRayTracer.h"
+#include "Async/ParallelFor.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoDepthCamera);
+
+
+namespace
+{
+	// Square tiles keep neighbouring rays, and the geoms they hit, on the same worker
+	constexpr int32 TileSize = 16;
+}
+
+
+UMujocoDepthCameraComponent::UMujocoDepthCameraComponent()
+{
+	// Images are rendered by the manager right after it steps the simulation
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UMujocoDepthCameraComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!Manager)
+	{
+		Manager = Cast<AMujocoManager>(GetOwner());
+	}
+
+	if (Manager)
+	{
+		Manager->RegisterDepthCamera(this);
+	}
+	else
+	{
+		UE_LOG(LogMujocoDepthCamera, Warning, TEXT("%s has no MuJoCo manager and will not render."), *GetName());
+	}
+}
+
+void UMujocoDepthCameraComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Manager)
+	{
+		Manager->UnregisterDepthCamera(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UMujocoDepthCameraComponent::CopyDepth(TArray<float>& OutDepth) const
+{
+	OutDepth.Reset(Depth.Num());
+	OutDepth.Append(Depth);
+}
+
+bool UMujocoDepthCameraComponent::BindToModel(const FMujocoAPI& Api, const mjModel* InModel)
+{
+	Unbind();
+
+	if (!InModel)
+	{
+		return false;
+	}
+
+	CameraId = Api.NameToId(InModel, mjOBJ_CAMERA, CameraName.ToString());
+	if (CameraId < 0)
+	{
+		UE_LOG(LogMujocoDepthCamera, Error, TEXT("%s: camera '%s' not found in the model."), *GetName(), *CameraName.ToString());
+		return false;
+	}
+	Model = InModel;
+	ImageWidth = FMath::Max(Width, 1);
+	ImageHeight = FMath::Max(Height, 1);
+
+	// MuJoCo cameras look along -Z with +Y up; cam_fovy is the vertical field of view in degrees
+	const double HalfHeight = FMath::Tan(0.5 * FMath::DegreesToRadians(static_cast<double>(Model->cam_fovy[CameraId])));
+	const double HalfWidth = HalfHeight * ImageWidth / ImageHeight;
+
+	LocalDirections.SetNumUninitialized(ImageWidth * ImageHeight);
+	Depth.Init(static_cast<float>(MaxRange), ImageWidth * ImageHeight);
+	for (int32 Row = 0; Row < ImageHeight; ++Row)
+	{
+		const double Y = HalfHeight * (1.0 - 2.0 * (Row + 0.5) / ImageHeight);
+		for (int32 Column = 0; Column < ImageWidth; ++Column)
+		{
+			const double X = HalfWidth * (2.0 * (Column + 0.5) / ImageWidth - 1.0);
+			LocalDirections[Row * ImageWidth + Column] = FVector3d(X, Y, -1.0).GetUnsafeNormal();
+		}
+	}
+
+	UE_LOG(LogMujocoDepthCamera, Log, TEXT("%s bound to camera %d at %dx%d"), *GetName(), CameraId, ImageWidth, ImageHeight);
+	return true;
+}
+
+void UMujocoDepthCameraComponent::Unbind()
+{
+	Model = nullptr;
+	CameraId = -1;
+}
+
+void UMujocoDepthCameraComponent::Render(const FMujocoRayTracer& Tracer, const mjData* Source)
+{
+	if (!Model || !Source || !Tracer.IsBound())
+	{
+		return;
+	}
+
+	const mjtNum* Origin = Source->cam_xpos + CameraId * 3;
+	const mjtNum* Frame = Source->cam_xmat + CameraId * 9;
+
+	// The resolution the buffers were sized for; Width and Height may have been edited since
+	const int32 TilesX = FMath::DivideAndRoundUp(ImageWidth, TileSize);
+	const int32 TilesY = FMath::DivideAndRoundUp(ImageHeight, TileSize);
+	ParallelFor(TilesX * TilesY, [this, &Tracer, Origin, Frame, TilesX](const int32 Tile)
+	{
+		const int32 FirstColumn = (Tile % TilesX) * TileSize;
+		const int32 FirstRow = (Tile / TilesX) * TileSize;
+		const int32 LastColumn = FMath::Min(FirstColumn + TileSize, ImageWidth);
+		const int32 LastRow = FMath::Min(FirstRow + TileSize, ImageHeight);
+
+		for (int32 Row = FirstRow; Row < LastRow; ++Row)
+		{
+			for (int32 Column = FirstColumn; Column < LastColumn; ++Column)
+			{
+				const int32 Pixel = Row * ImageWidth + Column;
+				const FVector3d& Local = LocalDirections[Pixel];
+
+				// Rotate into the world frame (xmat is row-major)
+				const double World[3] = {
+					Frame[0] * Local.X + Frame[1] * Local.Y + Frame[2] * Local.Z,
+					Frame[3] * Local.X + Frame[4] * Local.Y + Frame[5] * Local.Z,
+					Frame[6] * Local.X + Frame[7] * Local.Y + Frame[8] * Local.Z
+				};
+
+				// Trace far enough that a hit at the far plane is found even at the image corners
+				const double Distance = Tracer.Trace(Origin, World, MaxRange / -Local.Z, GeomGroupMask);
+				Depth[Pixel] = Distance >= 0.0 ? static_cast<float>(FMath::Min(Distance * -Local.Z, MaxRange)) : static_cast<float>(MaxRange);
+			}
+		}
+	});
+}
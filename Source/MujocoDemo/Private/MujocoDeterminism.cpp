@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoDeterminism.h"
+
+#include "Hash/xxhash.h"
+#include "HAL/FileManager.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoDeterminism);
+
+
+FMujocoDeterminismChecker::~FMujocoDeterminismChecker()
+{
+	CloseLog();
+}
+
+uint64 FMujocoDeterminismChecker::HashState(const mjModel* Model, const mjData* Data)
+{
+	FXxHash64Builder Builder;
+	Builder.Update(Data->qpos, Model->nq * sizeof(mjtNum));
+	Builder.Update(Data->qvel, Model->nv * sizeof(mjtNum));
+	Builder.Update(Data->act, Model->na * sizeof(mjtNum));
+	return Builder.Finalize().Hash;
+}
+
+bool FMujocoDeterminismChecker::OpenLog(const FString& FilePath, const mjModel* Model)
+{
+	CloseLog();
+
+	if (!Model)
+	{
+		UE_LOG(LogMujocoDeterminism, Error, TEXT("Cannot log state hashes without a model."));
+		return false;
+	}
+
+	Archive.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Archive)
+	{
+		UE_LOG(LogMujocoDeterminism, Error, TEXT("Failed to create hash stream: %s"), *FilePath);
+		return false;
+	}
+
+	FMujocoStateHashHeader Header;
+	Header.Nq = Model->nq;
+	Header.Nv = Model->nv;
+	Header.Na = Model->na;
+	Archive->Serialize(&Header, sizeof(Header));
+
+	UE_LOG(LogMujocoDeterminism, Log, TEXT("Logging state hashes to %s"), *FilePath);
+	return true;
+}
+
+void FMujocoDeterminismChecker::CloseLog()
+{
+	if (Archive)
+	{
+		Archive->Close();
+		Archive.Reset();
+	}
+}
+
+bool FMujocoDeterminismChecker::LoadReference(const FString& FilePath, const mjModel* Model)
+{
+	ClearReference();
+
+	if (!Model)
+	{
+		UE_LOG(LogMujocoDeterminism, Error, TEXT("Cannot compare state hashes without a model."));
+		return false;
+	}
+
+	const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader || Reader->TotalSize() < static_cast<int64>(sizeof(FMujocoStateHashHeader)))
+	{
+		UE_LOG(LogMujocoDeterminism, Error, TEXT("Failed to read hash stream: %s"), *FilePath);
+		return false;
+	}
+
+	FMujocoStateHashHeader Header;
+	Reader->Serialize(&Header, sizeof(Header));
+	if (Header.Magic != FMujocoStateHashHeader::MagicValue || Header.Version != FMujocoStateHashHeader::CurrentVersion)
+	{
+		UE_LOG(LogMujocoDeterminism, Error, TEXT("Not a hash stream (or unsupported version): %s"), *FilePath);
+		return false;
+	}
+
+	if (Header.Nq != Model->nq || Header.Nv != Model->nv || Header.Na != Model->na)
+	{
+		UE_LOG(LogMujocoDeterminism, Error, TEXT("Hash stream %s was recorded with a different model (nq %d vs %d)."), *FilePath, Header.Nq, Model->nq);
+		return false;
+	}
+
+	TArray<FMujocoStateHashEntry> Entries;
+	Entries.SetNumUninitialized((Reader->TotalSize() - sizeof(Header)) / sizeof(FMujocoStateHashEntry));
+	Reader->Serialize(Entries.GetData(), Entries.Num() * sizeof(FMujocoStateHashEntry));
+
+	// After a rewind the stream revisits steps; the first pass is the reference
+	Reference.Reserve(Entries.Num());
+	for (const FMujocoStateHashEntry& Entry : Entries)
+	{
+		if (!Reference.Contains(Entry.Step))
+		{
+			Reference.Add(Entry.Step, Entry.Hash);
+		}
+	}
+
+	UE_LOG(LogMujocoDeterminism, Log, TEXT("Comparing against %d reference hashes from %s"), Reference.Num(), *FilePath);
+	return !Reference.IsEmpty();
+}
+
+void FMujocoDeterminismChecker::ClearReference()
+{
+	Reference.Empty();
+	FirstDivergentStep = INDEX_NONE;
+	StepsCompared = 0;
+}
+
+bool FMujocoDeterminismChecker::Observe(const mjModel* Model, const mjData* Data, const int64 Step)
+{
+	LastHash = HashState(Model, Data);
+
+	if (Archive)
+	{
+		FMujocoStateHashEntry Entry;
+		Entry.Step = Step;
+		Entry.Hash = LastHash;
+		Archive->Serialize(&Entry, sizeof(Entry));
+	}
+
+	const uint64* Expected = FirstDivergentStep == INDEX_NONE ? Reference.Find(Step) : nullptr;
+	if (!Expected)
+	{
+		return true;
+	}
+
+	++StepsCompared;
+	if (*Expected == LastHash)
+	{
+		return true;
+	}
+
+	FirstDivergentStep = Step;
+	UE_LOG(LogMujocoDeterminism, Error, TEXT("State diverged from the reference at step %lld (time %.6f): hash %016llx, expected %016llx. %lld earlier steps matched."),
+		Step, Data->time, LastHash, *Expected, StepsCompared - 1);
+	return false;
+}
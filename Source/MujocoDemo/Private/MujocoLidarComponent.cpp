@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoLidarComponent.h"
+
+#include "MujocoAPI.h"
+#include "MujocoDataPool.h"
+#include "MujocoManager.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoLidar);
+
+
+UMujocoLidarComponent::UMujocoLidarComponent()
+{
+	// Scans are driven by the manager right after it steps the simulation
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UMujocoLidarComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!Manager)
+	{
+		Manager = Cast<AMujocoManager>(GetOwner());
+	}
+
+	if (Manager)
+	{
+		Manager->RegisterLidar(this);
+	}
+	else
+	{
+		UE_LOG(LogMujocoLidar, Warning, TEXT("%s has no MuJoCo manager and will not scan."), *GetName());
+	}
+}
+
+void UMujocoLidarComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Manager)
+	{
+		Manager->UnregisterLidar(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UMujocoLidarComponent::CopyDistances(TArray<double>& OutDistances) const
+{
+	OutDistances.Reset(Distances.Num());
+	OutDistances.Append(Distances);
+}
+
+bool UMujocoLidarComponent::BindToModel(const FMujocoAPI& Api, const mjModel* InModel, FMujocoDataPool& Pool)
+{
+	Unbind(Pool);
+
+	if (!InModel)
+	{
+		return false;
+	}
+
+	SiteId = -1;
+	BodyId = -1;
+	if (!SiteName.IsNone())
+	{
+		SiteId = Api.NameToId(InModel, mjOBJ_SITE, SiteName.ToString());
+		BodyId = SiteId >= 0 ? InModel->site_bodyid[SiteId] : -1;
+	}
+	else if (!BodyName.IsNone())
+	{
+		BodyId = Api.NameToId(InModel, mjOBJ_BODY, BodyName.ToString());
+	}
+
+	if (BodyId < 0)
+	{
+		UE_LOG(LogMujocoLidar, Error, TEXT("%s: mount frame '%s' not found in the model."), *GetName(),
+			*(SiteName.IsNone() ? BodyName : SiteName).ToString());
+		return false;
+	}
+
+	ScratchData = Pool.Acquire(InModel);
+	if (!ScratchData)
+	{
+		return false;
+	}
+	Model = InModel;
+
+	for (int32 Group = 0; Group < mjNGROUP; ++Group)
+	{
+		GeomGroup[Group] = (GeomGroupMask >> Group) & 1;
+	}
+
+	// Precompute the scan pattern in the sensor frame (+X forward, +Z up)
+	const int32 NumRays = GetNumRays();
+	LocalDirections.SetNumUninitialized(NumRays * 3);
+	WorldDirections.SetNumUninitialized(NumRays * 3);
+	Distances.SetNumUninitialized(NumRays);
+	HitGeoms.SetNumUninitialized(NumRays);
+
+	// A full revolution must not sample the same azimuth twice
+	const bool bFullCircle = HorizontalFov >= 360.0f;
+	const double AzimuthStep = FMath::DegreesToRadians(HorizontalFov) / FMath::Max(bFullCircle ? HorizontalSamples : HorizontalSamples - 1, 1);
+	const double ElevationStep = FMath::DegreesToRadians(VerticalFov) / FMath::Max(VerticalSamples - 1, 1);
+	const double AzimuthStart = -0.5 * FMath::DegreesToRadians(HorizontalFov);
+	const double ElevationStart = VerticalSamples > 1 ? -0.5 * FMath::DegreesToRadians(VerticalFov) : 0.0;
+
+	for (int32 Row = 0; Row < VerticalSamples; ++Row)
+	{
+		const double Elevation = ElevationStart + Row * ElevationStep;
+		for (int32 Column = 0; Column < HorizontalSamples; ++Column)
+		{
+			const double Azimuth = AzimuthStart + Column * AzimuthStep;
+			mjtNum* Direction = &LocalDirections[(Row * HorizontalSamples + Column) * 3];
+			Direction[0] = FMath::Cos(Elevation) * FMath::Cos(Azimuth);
+			Direction[1] = FMath::Cos(Elevation) * FMath::Sin(Azimuth);
+			Direction[2] = FMath::Sin(Elevation);
+		}
+	}
+
+	UE_LOG(LogMujocoLidar, Log, TEXT("%s bound to body %d with %d rays"), *GetName(), BodyId, NumRays);
+	return true;
+}
+
+void UMujocoLidarComponent::Unbind(FMujocoDataPool& Pool)
+{
+	if (ScratchData)
+	{
+		Pool.Release(Model, ScratchData);
+		ScratchData = nullptr;
+	}
+	Model = nullptr;
+}
+
+void UMujocoLidarComponent::Scan(const FMujocoAPI& Api, const mjData* Source)
+{
+	if (!Model || !ScratchData || !Source)
+	{
+		return;
+	}
+
+	// mj_multiRay only reads the geom (and flex vertex) poses, and needs a private stack
+	// to run concurrently with other sensors, so mirror just those poses into the scratch data.
+	FMemory::Memcpy(ScratchData->geom_xpos, Source->geom_xpos, Model->ngeom * 3 * sizeof(mjtNum));
+	FMemory::Memcpy(ScratchData->geom_xmat, Source->geom_xmat, Model->ngeom * 9 * sizeof(mjtNum));
+	if (Model->nflexvert > 0)
+	{
+		FMemory::Memcpy(ScratchData->flexvert_xpos, Source->flexvert_xpos, Model->nflexvert * 3 * sizeof(mjtNum));
+	}
+
+	const mjtNum* Origin = SiteId >= 0 ? Source->site_xpos + SiteId * 3 : Source->xpos + BodyId * 3;
+	const mjtNum* Frame = SiteId >= 0 ? Source->site_xmat + SiteId * 9 : Source->xmat + BodyId * 9;
+
+	// Rotate the pattern into the world frame (xmat is row-major)
+	const int32 NumRays = HitGeoms.Num();
+	for (int32 i = 0; i < NumRays; ++i)
+	{
+		const mjtNum* Local = &LocalDirections[i * 3];
+		mjtNum* World = &WorldDirections[i * 3];
+		World[0] = Frame[0] * Local[0] + Frame[1] * Local[1] + Frame[2] * Local[2];
+		World[1] = Frame[3] * Local[0] + Frame[4] * Local[1] + Frame[5] * Local[2];
+		World[2] = Frame[6] * Local[0] + Frame[7] * Local[1] + Frame[8] * Local[2];
+	}
+
+	Api.MultiRay(Model, ScratchData, Origin, WorldDirections.GetData(), GeomGroup, bIncludeStatic,
+		bExcludeMountBody ? BodyId : -1, HitGeoms.GetData(), Distances.GetData(), NumRays, MaxRange);
+}
@@ -4,13 +4,55 @@
 #include <mujoco/mujoco.h>
 
 #include "MaterialDomain.h"
+#include "MujocoDepthCameraComponent.h"
+#include "MujocoLidarComponent.h"
+#include "MujocoPrimitiveMeshSubsystem.h"
+#include "MujocoWorldSubsystem.h"
+#include "Async/ParallelFor.h"
 #include "Components/DynamicMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/LineBatchComponent.h"
 #include "DynamicMesh/DynamicMesh3.h"
+#include "Engine/Engine.h"
 
 
 DEFINE_LOG_CATEGORY(LogMujocoManager);
 
 
+namespace
+{
+	/** Set by HandleMujocoError on the thread whose MuJoCo call failed */
+	thread_local bool bMujocoErrorRaised = false;
+
+	/** Replaces MuJoCo's default error handler, which exits the process */
+	void HandleMujocoError(const char* Message)
+	{
+		UE_LOG(LogMujocoManager, Error, TEXT("MuJoCo error: %s"), UTF8_TO_TCHAR(Message));
+		bMujocoErrorRaised = true;
+	}
+
+	/** Pose every instance with Pose(Geom, OutPosition, OutRotation) and update each batch in one call */
+	template <typename PoseFuncType>
+	void UpdateGeomBatches(TArray<FMujocoGeomBatch>& Batches, TArray<FTransform>& Transforms, PoseFuncType&& Pose)
+	{
+		for (FMujocoGeomBatch& Batch : Batches)
+		{
+			if (!Batch.Component) continue;
+
+			Transforms.SetNum(Batch.Geoms.Num(), EAllowShrinking::No);
+			for (int32 Instance = 0; Instance < Batch.Geoms.Num(); ++Instance)
+			{
+				FVector Position;
+				FQuat Rotation;
+				Pose(Batch.Geoms[Instance], Position, Rotation);
+				Transforms[Instance] = FTransform(Rotation, Position, Batch.Scales[Instance]);
+			}
+			Batch.Component->BatchUpdateInstancesTransforms(0, Transforms, true, true);
+		}
+	}
+}
+
+
 // Sets default values
 AMujocoManager::AMujocoManager()
 {
@@ -23,10 +65,12 @@ AMujocoManager::AMujocoManager()
 	bApplyControl = false;
 	
 	MujocoApi = std::make_shared<FMujocoAPI>();
+	DataPool = std::make_shared<FMujocoDataPool>(MujocoApi);
 	if (MujocoApi->LoadMuJoCo())
 	{
 		const FString APIVersion = MujocoApi->GetVersionString();
 		UE_LOG(LogMujocoManager, Display, TEXT("MujocoAPI Version: %s"), *APIVersion);
+		MujocoApi->SetErrorHandler(&HandleMujocoError);
 	} else
 	{
 		UE_LOG(LogMujocoManager, Error, TEXT("Failed to load MujocoAPI!"));
@@ -64,8 +108,211 @@ bool AMujocoManager::LoadModel()
 		return false;
 	}
 	
-	MjModel = MujocoApi->LoadModelFromXML(MuJoCoXMLPath);
+	// Going through a spec keeps the model editable at runtime
+	UnloadModel();
+	TUniquePtr<FMujocoSceneBuilder> Builder = MakeSceneBuilder();
+	if (!Builder->BeginScene(MuJoCoXMLPath) || !LoadScene(MoveTemp(Builder)))
+	{
+		return false;
+	}
+
+	UE_LOG(LogMujocoManager, Log, TEXT("Successfully loaded MuJoCo model from raw XML."));
+	return true;
+}
+
+bool AMujocoManager::LoadScene(TUniquePtr<FMujocoSceneBuilder> Builder)
+{
+	if (!Builder)
+	{
+		return false;
+	}
+
+	UnloadModel();
+	if (!InitializeModel(Builder->Compile()))
+	{
+		return false;
+	}
+
+	SceneBuilder = MoveTemp(Builder);
+	return true;
+}
+
+bool AMujocoManager::SpawnRobots(const FString& SceneXMLPath, const FString& RobotXMLPath, const TArray<FTransform>& Placements)
+{
+	TUniquePtr<FMujocoSceneBuilder> Builder = MakeSceneBuilder();
+	const int32 Robot = Builder->BeginScene(SceneXMLPath) ? Builder->AddTemplate(RobotXMLPath) : INDEX_NONE;
+	if (Robot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	for (const FTransform& Placement : Placements)
+	{
+		if (Builder->AddInstance(Robot, Conversion.ToMujocoPosition(Placement.GetLocation()), Conversion.ToMujocoRotation(Placement.GetRotation())) == INDEX_NONE)
+		{
+			return false;
+		}
+	}
+
+	return LoadScene(MoveTemp(Builder));
+}
+
+TArray<FMujocoRobotInstance> AMujocoManager::GetRobotInstances() const
+{
+	return SceneBuilder ? SceneBuilder->GetInstances() : TArray<FMujocoRobotInstance>();
+}
+
+void AMujocoManager::ReadRobotState(const FMujocoRobotInstance& Robot, TArray<double>& OutQpos, TArray<double>& OutQvel) const
+{
+	OutQpos.Reset(Robot.NumQpos);
+	OutQpos.Append(GetRobotQpos(Robot));
+	OutQvel.Reset(Robot.NumDofs);
+	OutQvel.Append(GetRobotQvel(Robot));
+}
+
+void AMujocoManager::SetRobotControls(const FMujocoRobotInstance& Robot, const TArray<double>& Values)
+{
+	ControlBuffer.SetControls(TConstArrayView<double>(Values).Left(Robot.NumActuators), Robot.FirstActuator);
+}
+
+FMujocoBodyHandle AMujocoManager::AddBox(const FName Name, const FTransform& Transform, const FVector HalfExtents, const double Mass, const bool bFreeJoint)
+{
+	if (!SceneBuilder || !SceneBuilder->AddPrimitiveBody(Name.ToString(), mjGEOM_BOX, Conversion.ToMujocoSize(HalfExtents), Conversion.ToMujocoPosition(Transform.GetLocation()), Conversion.ToMujocoRotation(Transform.GetRotation()), Mass, bFreeJoint))
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot add box '%s'. Load a model first."), *Name.ToString());
+		return FMujocoBodyHandle();
+	}
+
+	return ApplySceneEdit() ? NameIndex.FindBody(Name) : FMujocoBodyHandle();
+}
+
+bool AMujocoManager::RemoveBody(const FName Name)
+{
+	return SceneBuilder && SceneBuilder->RemoveBody(Name.ToString()) && ApplySceneEdit();
+}
 
+bool AMujocoManager::ApplySceneEdit()
+{
+	if (!SceneBuilder || !MjModel || !MjData)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot apply scene edit. Model or data is missing."));
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// A failed recompile leaves the model as it was, so the current bindings stay valid
+	TArray<int32> GeomRemap;
+	if (!SceneBuilder->Recompile(MjModel, MjData, GeomRemap))
+	{
+		return false;
+	}
+
+	// Anything holding states of the old layout cannot follow the edit
+	if (TrajectoryWriter.IsOpen())
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Scene edit ends the trajectory recording."));
+	}
+	if (TrajectoryReader.IsOpen())
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Scene edit stops the replay of a trajectory recorded with the old scene."));
+	}
+	if (Determinism.IsActive())
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Scene edit stops state hash logging and determinism checks."));
+	}
+	if (RewindBuffer.IsInitialized() && !RewindBuffer.IsEmpty())
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Scene edit clears the rewind history."));
+	}
+
+	const int32 NumRollouts = RolloutPool.GetNumRollouts();
+	UnbindModel(true);
+
+	// Pooled spares, including those just returned by the unbind, still have the old layout
+	DataPool->Trim(MjModel);
+
+	MujocoApi->Forward(MjModel, MjData);
+	BindModel();
+	if (NumRollouts > 0)
+	{
+		RolloutPool.Initialize(DataPool, MjModel, NumRollouts);
+	}
+	PatchSpawnedMeshes(GeomRemap);
+	UE_LOG(LogMujocoManager, Log, TEXT("Applied scene edit in %.2f ms (%d geoms)."), (FPlatformTime::Seconds() - StartTime) * 1000.0, MjModel->ngeom);
+	return true;
+}
+
+void AMujocoManager::PatchSpawnedMeshes(const TConstArrayView<int32> GeomRemap)
+{
+	TMap<int32, UMeshComponent*> Patched;
+	Patched.Reserve(SpawnedMeshes.Num());
+	for (const auto& MeshPair : SpawnedMeshes)
+	{
+		const int32 NewGeom = GeomRemap.IsValidIndex(MeshPair.Key) ? GeomRemap[MeshPair.Key] : INDEX_NONE;
+		if (NewGeom != INDEX_NONE)
+		{
+			Patched.Add(NewGeom, MeshPair.Value);
+		}
+		else
+		{
+			DestroySpawnedMesh(MeshPair.Value);
+		}
+	}
+	SpawnedMeshes = MoveTemp(Patched);
+
+	for (int32 BatchIndex = GeomBatches.Num() - 1; BatchIndex >= 0; --BatchIndex)
+	{
+		// Backwards, since removing an instance shifts the ones after it down
+		FMujocoGeomBatch& Batch = GeomBatches[BatchIndex];
+		for (int32 Instance = Batch.Geoms.Num() - 1; Instance >= 0; --Instance)
+		{
+			const int32 NewGeom = GeomRemap.IsValidIndex(Batch.Geoms[Instance]) ? GeomRemap[Batch.Geoms[Instance]] : INDEX_NONE;
+			if (NewGeom != INDEX_NONE)
+			{
+				Batch.Geoms[Instance] = NewGeom;
+			}
+			else
+			{
+				Batch.Component->RemoveInstance(Instance);
+				Batch.Geoms.RemoveAt(Instance);
+				Batch.Scales.RemoveAt(Instance);
+			}
+		}
+
+		if (Batch.Geoms.IsEmpty())
+		{
+			DestroySpawnedMesh(Batch.Component);
+			GeomBatches.RemoveAt(BatchIndex);
+		}
+	}
+
+	// Meshes in use stay referenced by their components; new heightfield geoms look theirs up afresh
+	HeightfieldMeshes.Reset();
+
+	// Geoms no old geom maps to are new
+	TBitArray<> Existing(false, MjModel->ngeom);
+	for (const int32 NewGeom : GeomRemap)
+	{
+		if (NewGeom != INDEX_NONE)
+		{
+			Existing[NewGeom] = true;
+		}
+	}
+	for (int32 Geom = 0; Geom < MjModel->ngeom; ++Geom)
+	{
+		if (!Existing[Geom])
+		{
+			SpawnGeom(Geom);
+		}
+	}
+
+	ApplyGeomPosesToMeshes();
+}
+
+bool AMujocoManager::InitializeModel(mjModel* Model)
+{
+	MjModel = Model;
 	if (!MjModel)
 	{
 		UE_LOG(LogMujocoManager, Error, TEXT("Failed to compile MuJoCo model."));
@@ -73,7 +320,7 @@ bool AMujocoManager::LoadModel()
 	}
 
 	// Allocate simulation data
-	MjData = MujocoApi->CreateData(MjModel);
+	MjData = DataPool->Acquire(MjModel);
 	if (!MjData)
 	{
 		UE_LOG(LogMujocoManager, Error, TEXT("Failed to allocate mjData."));
@@ -83,37 +330,172 @@ bool AMujocoManager::LoadModel()
 	}
 
 	MujocoApi->Forward(MjModel, MjData);
-	SpawnMuJoCoObjects();
+	SimulationStep = 0;
+	StepClock.Reset();
+	BindModel();
 
-	UE_LOG(LogMujocoManager, Log, TEXT("Successfully loaded MuJoCo model from raw XML."));
+	SpawnMuJoCoObjects();
 	return true;
 }
 
-void AMujocoManager::StepSimulation()
+void AMujocoManager::BindModel()
+{
+	MemoryTelemetry.Reset(MjModel);
+	bArenaTuned = false;
+	PendingArenaBytes = 0;
+
+	if (bEnableRewind && RewindBuffer.Initialize(*MujocoApi, MjModel, static_cast<int64>(RewindBudgetMegabytes) * 1024 * 1024, RewindKeyframeInterval))
+	{
+		RewindBuffer.Capture(*MujocoApi, MjModel, MjData, SimulationStep);
+	}
+
+	NameIndex.Build(MjModel);
+	ControlBuffer.Initialize(MjModel, MjData);
+	for (int32 Index = 0; Index < Controllers.Num(); ++Index)
+	{
+		BoundControllers[Index] = Controllers[Index]->Bind(MjModel);
+	}
+
+	StreamedSensorBatch = ResolveSensors(StreamedSensors);
+	ContactQuery.Bind(MjModel);
+	PoseBuffer.Initialize(MjModel, MjData, SimulationStep);
+
+	if (bEnablePolicyBridge)
+	{
+		PolicyBridge.Create(PolicyBridgeName, 1 + MjModel->nq + MjModel->nv, MjModel->nu);
+		bPolicyResponding = true;
+	}
+	SensorTable.Build(MjModel, NameIndex);
+
+	ControlActuator = NameIndex.FindActuator(ControlActuatorName);
+	if (!ControlActuator.IsValid() && MjModel->nu > 0)
+	{
+		if (!ControlActuatorName.IsNone())
+		{
+			UE_LOG(LogMujocoManager, Warning, TEXT("Actuator '%s' not found, controlling the first actuator."), *ControlActuatorName.ToString());
+		}
+		ControlActuator.Id = 0;
+	}
+
+	TrackedBody = NameIndex.FindBody(TrackedBodyName);
+	if (!TrackedBody.IsValid() && MjModel->nbody > 1)
+	{
+		TrackedBody.Id = 1;
+	}
+
+	for (UMujocoLidarComponent* Lidar : LidarSensors)
+	{
+		Lidar->BindToModel(*MujocoApi, MjModel, *DataPool);
+	}
+
+	// Mesh BVHs are only worth building when something is going to trace against them
+	if (!DepthCameras.IsEmpty())
+	{
+		RayTracer.BindToModel(MujocoApi, MjModel);
+	}
+	for (UMujocoDepthCameraComponent* Camera : DepthCameras)
+	{
+		Camera->BindToModel(*MujocoApi, MjModel);
+	}
+}
+
+bool AMujocoManager::StepSimulation()
 {
 	if (MjModel && MjData)
 	{
 		UE_LOG(LogMujocoManager, VeryVerbose, TEXT("StepSimulation"));
 
-		// Apply forward control input to first actuator
+		// Apply forward control input to the control actuator
 		if (bApplyControl)
 		{
-			if (MjModel->nu > 0)
+			if (ControlActuator.IsValid())
+			{
+				ControlBuffer.SetControl(ControlActuator.Id, InputControl);
+			}
+		}
+
+		if (PolicyBridge.IsOpen())
+		{
+			ExchangeWithPolicy();
+		}
+
+		ControlBuffer.SetInterpolationTime(ControlInterpolationTime);
+		ControlBuffer.Apply(MjData);
+
+		for (int32 Index = 0; Index < Controllers.Num(); ++Index)
+		{
+			if (BoundControllers[Index])
 			{
-				MjData->ctrl[0] = static_cast<mjtNum>(InputControl);
+				Controllers[Index]->Compute(MjModel, MjData);
 			}
 		}
 
 		if (MjData->warning[mjWARN_BADQPOS].number > 0)
 		{
 			UE_LOG(LogMujocoManager, Error, TEXT("Simulation Diverged: Bad qpos detected!"));
-			return;
+			return false;
 		}
 
 		// Step simulation one time
+		bMujocoErrorRaised = false;
 		MujocoApi->Step(MjModel, MjData);
 		MujocoApi->Forward(MjModel, MjData);
+		if (bMujocoErrorRaised)
+		{
+			// The data is in an undefined state until the simulation is reset or the model reloaded
+			UE_LOG(LogMujocoManager, Error, TEXT("Stopping the simulation after a MuJoCo error at step %lld."), SimulationStep);
+			bStepSimulation = false;
+			return false;
+		}
 		bLogStateChange = true;
+		++SimulationStep;
+
+		if (Determinism.IsActive())
+		{
+			Determinism.Observe(MjModel, MjData, SimulationStep);
+		}
+
+		if (ShouldInterpolatePoses())
+		{
+			PoseBuffer.Capture(MjData, SimulationStep);
+		}
+
+		if (RewindBuffer.IsInitialized())
+		{
+			RewindBuffer.Capture(*MujocoApi, MjModel, MjData, SimulationStep);
+		}
+
+		// Resizing replaces MjData and rebinds components, so it waits for the game thread in SyncToScene
+		MemoryTelemetry.Observe(MjData);
+		if (MemoryTelemetry.HadOverflow())
+		{
+			UE_LOG(LogMujocoManager, Warning, TEXT("mjData arena full (%lld bytes): contacts or constraints were dropped."), MemoryTelemetry.GetStats().ArenaBytes);
+			if (bAutoTuneArena)
+			{
+				PendingArenaBytes = FMath::Max(PendingArenaBytes, MemoryTelemetry.GetStats().ArenaBytes * 2);
+			}
+		}
+		else if (bAutoTuneArena && !bArenaTuned && PendingArenaBytes == 0 && MemoryTelemetry.GetStats().StepsObserved >= ArenaTuneAfterSteps)
+		{
+			bArenaTuned = true;
+			PendingArenaBytes = MemoryTelemetry.GetRecommendedArenaBytes(ArenaHeadroom);
+		}
+
+		if (bExtractContacts)
+		{
+			ContactQuery.Extract(*MujocoApi, MjModel, MjData);
+		}
+
+		if (TrajectoryWriter.IsOpen())
+		{
+			TrajectoryWriter.Append(*MujocoApi, MjModel, MjData);
+		}
+
+		if (StateStreamer.IsRunning())
+		{
+			StateStreamer.Publish(MjModel, MjData, SimulationStep, StreamedSensorBatch);
+		}
+		return true;
 	}
 	else
 	{
@@ -130,6 +512,7 @@ void AMujocoManager::StepSimulation()
 			}
 		}
 	}
+	return false;
 }
 
 void AMujocoManager::SpawnMuJoCoObjects()
@@ -145,71 +528,64 @@ void AMujocoManager::SpawnMuJoCoObjects()
 
     for (int i = 0; i < ModelCount; i++)
     {
-        const FVector Position(
-            MjModel->geom_pos[i * 3] * PositionScale, 
-            MjModel->geom_pos[i * 3 + 1] * PositionScale, 
-            MjModel->geom_pos[i * 3 + 2] * PositionScale
-        );
-
-        const FVector Size(
-            MjModel->geom_size[i * 3] * SizeScale, // MuJoCo uses half-sizes
-            MjModel->geom_size[i * 3 + 1] * SizeScale,
-            MjModel->geom_size[i * 3 + 2] * SizeScale
-        );
-
-        FQuat Rotation(
-            MjModel->geom_quat[i * 4 + 3],  // w
-            MjModel->geom_quat[i * 4],      // x
-            MjModel->geom_quat[i * 4 + 1],  // y
-            MjModel->geom_quat[i * 4 + 2]   // z
-        );
-
-        // Determine the geometry type
-        UStaticMesh* MeshAsset;
-        switch (const int ModelType = MjModel->geom_type[i])
-        {
-        case mjGEOM_BOX:
-            MeshAsset = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
-        	HandleStaticMeshObject(i, Position, Size, Rotation, MeshAsset);
-        	break;
-        case mjGEOM_SPHERE:
-            MeshAsset = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
-        	HandleStaticMeshObject(i, Position, Size, Rotation, MeshAsset);
-            break;
-        case mjGEOM_PLANE:
-            MeshAsset = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Plane.Plane"));
-        	HandleStaticMeshObject(i, Position, Size, Rotation, MeshAsset);
-            break;
-		case mjGEOM_CAPSULE:
-			{
-				UE_LOG(LogMujocoManager, Log, TEXT("Loading Capsule"));
-
-				// Load capsule asset (Ensure you have a valid capsule mesh in Unreal)
-				MeshAsset = LoadObject<UStaticMesh>(nullptr, TEXT("/Game/StarterContent/Shapes/Shape_NarrowCapsule.Shape_NarrowCapsule"));
+        SpawnGeom(i);
+    }
+}
 
-				const int Body_ID = MjModel->geom_bodyid[i];
+void AMujocoManager::SpawnGeom(const int i)
+{
+    // World pose from the last forward pass; the model's geom_pos is relative to the body
+    const FVector Position = Conversion.ToUnrealPosition(MjData->geom_xpos + i * 3);
+    const FQuat Rotation = Conversion.ToUnrealRotation(MjData->geom_xmat + i * 9);
 
-				// Extract body orientation quaternion
-				const FQuat BodyRotation(
-					MjModel->body_quat[Body_ID * 4 + 3],  // w
-					MjModel->body_quat[Body_ID * 4],      // x
-					MjModel->body_quat[Body_ID * 4 + 1],  // y
-					MjModel->body_quat[Body_ID * 4 + 2]   // z
-				);
+    // MuJoCo sizes are half-sizes in geom-local order, which the converted rotation preserves
+    const FVector HalfSize = Conversion.ToUnrealSize(FVector(
+        MjModel->geom_size[i * 3],
+        MjModel->geom_size[i * 3 + 1],
+        MjModel->geom_size[i * 3 + 2]
+    ));
 
-				Rotation = BodyRotation;
-				HandleStaticMeshObject(i, Position, Size, Rotation, MeshAsset);
+    // Determine the geometry type
+    switch (const mjtGeom ModelType = static_cast<mjtGeom>(MjModel->geom_type[i]))
+    {
+	case mjGEOM_MESH:
+		{
+			// Vertices are converted to Unreal units, so the component is not scaled
+			HandleDynamicMeshObject(i, Position, FVector::OneVector, Rotation);
+		}
+    	break;
+	case mjGEOM_HFIELD:
+		{
+			// Built once per heightfield at its full size and shared by the geoms using it
+			const int32 Hfield = MjModel->geom_dataid[i];
+			UStaticMesh* HeightfieldMesh = HeightfieldMeshes.FindRef(Hfield);
+			if (!HeightfieldMesh)
+			{
+				HeightfieldMesh = UMujocoPrimitiveMeshSubsystem::CreateHeightfield(MjModel, Hfield, Conversion, this);
+				if (!HeightfieldMesh)
+				{
+					UE_LOG(LogMujocoManager, Warning, TEXT("Unsupported geometry type. Skipping. (%i)"), static_cast<int32>(ModelType));
+					return;
+				}
+				HeightfieldMeshes.Add(Hfield, HeightfieldMesh);
 			}
-        	break;
-		case mjGEOM_MESH:
+			HandleStaticMeshObject(i, Position, FVector::OneVector, Rotation, HeightfieldMesh);
+		}
+		break;
+    default:
+		{
+			// Primitives share one unit mesh per type, sized by the instance scale
+			UMujocoPrimitiveMeshSubsystem* PrimitiveMeshes = GEngine ? GEngine->GetEngineSubsystem<UMujocoPrimitiveMeshSubsystem>() : nullptr;
+			FVector Scale;
+			UStaticMesh* MeshAsset = PrimitiveMeshes ? PrimitiveMeshes->FindOrCreate(ModelType, HalfSize, Scale) : nullptr;
+			if (!MeshAsset)
 			{
-				HandleDynamicMeshObject(i, Position, Size, Rotation);
+				UE_LOG(LogMujocoManager, Warning, TEXT("Unsupported geometry type. Skipping. (%i)"), static_cast<int32>(ModelType));
+				return;
 			}
-        	break;
-        default:
-            UE_LOG(LogMujocoManager, Warning, TEXT("Unsupported geometry type. Skipping. (%i)"), ModelType);
-            continue;
-        }
+			HandleStaticMeshObject(i, Position, Scale, Rotation, MeshAsset);
+		}
+		break;
     }
 }
 
@@ -228,37 +604,51 @@ void AMujocoManager::HandleStaticMeshObject(const int ModelNum, const FVector& P
 		MjModel->geom_rgba[ModelNum * 4 + 2], // Blue
 		MjModel->geom_rgba[ModelNum * 4 + 3]  // Alpha
 	);
-	
-    // Load a base material (we are using our own basic material in Unreal with a color parameter)
-    UMaterialInterface* BaseMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/StarterContent/Materials/BaseDemoMat.BaseDemoMat"));
-    if (!BaseMaterial)
-    {
-    	UE_LOG(LogMujocoManager, Warning, TEXT("Failed to load base material. Using default Unreal material."));
-    	BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
-    }
 
-    // Create a dynamic material instance and apply color
-    UMaterialInstanceDynamic* DynamicMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
-    if (DynamicMaterial)
-    {
-    	DynamicMaterial->SetVectorParameterValue("MainColor", ObjectColor);
-    	UE_LOG(LogMujocoManager, Verbose, TEXT("Object Color: %.3f, %.3f, %.3f, %.3f"), ObjectColor.R, ObjectColor.G, ObjectColor.B, ObjectColor.A);
-    }
+	// Geoms of one mesh and color share a component and draw together
+	FMujocoGeomBatch* Batch = GeomBatches.FindByPredicate([Mesh, &ObjectColor](const FMujocoGeomBatch& Candidate)
+	{
+		return Candidate.Component && Candidate.Component->GetStaticMesh() == Mesh && Candidate.Color == ObjectColor;
+	});
+	if (!Batch)
+	{
+		// Load a base material (we are using our own basic material in Unreal with a color parameter)
+		UMaterialInterface* BaseMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/StarterContent/Materials/BaseDemoMat.BaseDemoMat"));
+		if (!BaseMaterial)
+		{
+			UE_LOG(LogMujocoManager, Warning, TEXT("Failed to load base material. Using default Unreal material."));
+			BaseMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+		}
+
+		// Create a dynamic material instance and apply color
+		UMaterialInstanceDynamic* DynamicMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
+		if (DynamicMaterial)
+		{
+			DynamicMaterial->SetVectorParameterValue("MainColor", ObjectColor);
+			UE_LOG(LogMujocoManager, Verbose, TEXT("Object Color: %.3f, %.3f, %.3f, %.3f"), ObjectColor.R, ObjectColor.G, ObjectColor.B, ObjectColor.A);
+		}
+
+		// Create a new instanced mesh component
+		UInstancedStaticMeshComponent* NewMesh = NewObject<UInstancedStaticMeshComponent>(this);
+		if (!NewMesh) return;
+
+		NewMesh->SetStaticMesh(Mesh);
+		NewMesh->SetMaterial(0, DynamicMaterial);
+
+		// Instances move every frame; per-instance physics bodies would be rebuilt on every update
+		NewMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		NewMesh->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepWorldTransform);
+		NewMesh->RegisterComponent();
+		AddInstanceComponent(NewMesh);
+
+		Batch = &GeomBatches.AddDefaulted_GetRef();
+		Batch->Component = NewMesh;
+		Batch->Color = ObjectColor;
+	}
 
-    // Create a new mesh component
-    UStaticMeshComponent* NewMesh = NewObject<UStaticMeshComponent>(this);
-	if (!NewMesh) return;
-
-    NewMesh->SetMaterial(0, DynamicMaterial);
-    NewMesh->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepWorldTransform);
-    NewMesh->SetStaticMesh(Mesh);
-    NewMesh->SetWorldLocation(Position);
-    NewMesh->SetWorldRotation(Rotation);
-    NewMesh->SetWorldScale3D(Size);
-    NewMesh->RegisterComponent();
-    
-    AddInstanceComponent(NewMesh);
-    SpawnedMeshes.Add(ModelNum, NewMesh);
+	Batch->Component->AddInstance(FTransform(Rotation, Position, Size), true);
+	Batch->Geoms.Add(ModelNum);
+	Batch->Scales.Add(Size);
 
     UE_LOG(LogMujocoManager, Verbose, TEXT("%d at (%.2f, %.2f, %.2f), (%.2f, %.2f, %.2f), (%.2f, %.2f, %.2f)"),
     	ModelNum, Position.X, Position.Y, Position.Z,
@@ -289,17 +679,14 @@ void AMujocoManager::HandleDynamicMeshObject(const int ModelNum, const FVector&
 	UE_LOG(LogMujocoManager, Log, TEXT("Normal array address: %p"), Normals);
 	UE_LOG(LogMujocoManager, Log, TEXT("Face array address: %p"), Faces);
 	
-	for (int i = 0; i < TotalNumberOfMeshVerts; ++i) {
-		const double VertOne = Vertices[i * 3] * VertexScale;
-		const double VertTwo = Vertices[i * 3 + 1] * VertexScale;
-		const double VertThree = Vertices[i * 3 + 2] * VertexScale;
-		FVector3d CurrentVertex = FVector3d(VertOne, VertTwo, VertThree);
-		DynamicMesh.AppendVertex(CurrentVertex);
-		
-		// Log vertex data
-		UE_LOG(LogMujocoManager, Verbose,
-			   TEXT("Vertex %i: %.3f, %.3f, %.3f"), i, VertOne, VertTwo, VertThree);
-	}
+	Conversion.Dispatch([&](auto Axes) {
+		for (int i = 0; i < TotalNumberOfMeshVerts; ++i) {
+			DynamicMesh.AppendVertex(MujocoConversion::ToUnrealVertex<decltype(Axes)>(Vertices + i * 3, Conversion.UnitScale));
+		}
+	});
+
+	// A mirroring conversion turns the triangles inside out unless they are wound the other way
+	const bool bFlipWinding = Conversion.FlipsWinding();
 	
 	// Add Triangles (Faces)
 	for (int i = 0; i < TotalNumOfFaces; ++i) {
@@ -321,22 +708,18 @@ void AMujocoManager::HandleDynamicMeshObject(const int ModelNum, const FVector&
 		  continue; // Skip this triangle
 		}
 		
-		UE::Geometry::FIndex3i CurrentTriangle(IndexOne, IndexTwo, IndexThree);
+		UE::Geometry::FIndex3i CurrentTriangle = bFlipWinding ? UE::Geometry::FIndex3i(IndexOne, IndexThree, IndexTwo) : UE::Geometry::FIndex3i(IndexOne, IndexTwo, IndexThree);
 		DynamicMesh.AppendTriangle(CurrentTriangle);
 	}
 	
 	// Add Normals (assuming one normal per vertex - adjust if needed)
 	if (TotalNumOfNormals == TotalNumberOfMeshVerts) {
-		for (int i = 0; i < TotalNumOfNormals; ++i) {
-		  FVector3f CurrentNormal = FVector3f(Normals[i * 3], Normals[i * 3 + 1],
-												Normals[i * 3 + 2]);
-		  DynamicMesh.SetVertexNormal(i, CurrentNormal);
-		
-		  // Log normal data
-		  UE_LOG(LogMujocoManager, Log,
-				 TEXT("Normal %i: %.3f, %.3f, %.3f"), i, Normals[i * 3],
-				 Normals[i * 3 + 1], Normals[i * 3 + 2]);
-		}
+		// Normals mirror with the vertices but keep unit length
+		Conversion.Dispatch([&](auto Axes) {
+			for (int i = 0; i < TotalNumOfNormals; ++i) {
+				DynamicMesh.SetVertexNormal(i, FVector3f(MujocoConversion::ToUnrealVertex<decltype(Axes)>(Normals + i * 3, 1.0)));
+			}
+		});
 	} else {
 		UE_LOG(LogMujocoManager, Log,
 			   TEXT("Number of normals does not match number of vertices.  "
@@ -514,56 +897,571 @@ void AMujocoManager::UpdateMuJoCoObjects()
 
 	MujocoApi->Forward(MjModel, MjData); // Update kinematics
 
-	for (const auto& MeshPair : SpawnedMeshes)
+	if (ShouldInterpolatePoses() && PoseBuffer.IsInitialized())
+	{
+		// Captures are skipped while interpolation is off, so resynchronize rather than blend from a stale frame
+		if (PoseBuffer.GetCurrentStep() != SimulationStep)
+		{
+			PoseBuffer.Reset(MjData, SimulationStep);
+		}
+		PoseBuffer.Blend(StepMode == EMujocoStepMode::AsFastAsPossible ? 1.0 : StepClock.GetAlpha(MjModel->opt.timestep));
+		ApplyInterpolatedPosesToMeshes();
+	}
+	else
 	{
-		const int32 BodyIndex = MeshPair.Key;
-		// This will break probably with the dynamic meshes lol
-		UMeshComponent* Mesh = MeshPair.Value;
+		ApplyGeomPosesToMeshes();
+	}
+}
 
-		if (!Mesh) continue;
+void AMujocoManager::ApplyGeomPosesToMeshes()
+{
+	// One dispatch per frame; the loop below is specialized for the axis convention
+	Conversion.Dispatch([this](auto Axes)
+	{
+		using FAxes = decltype(Axes);
+		auto GeomPose = [this](const int32 BodyIndex, FVector& Position, FQuat& Rotation)
+		{
+			Position = MujocoConversion::ToUnrealPosition<FAxes>(MjData->geom_xpos + BodyIndex * 3, Conversion.UnitScale);
+			Rotation = MujocoConversion::ToUnrealRotation<FAxes>(MujocoConversion::MatrixToQuat(MjData->geom_xmat + BodyIndex * 9));
+		};
 
-		// Convert MuJoCo position to Unreal world position
-		const FVector Position(
-			MjData->geom_xpos[BodyIndex * 3] * PositionScale, 
-			MjData->geom_xpos[BodyIndex * 3 + 1] * PositionScale, 
-			MjData->geom_xpos[BodyIndex * 3 + 2] * PositionScale
-		);
-		
-		// convert MjData->geom_xmat to quaternion
-		FMatrix MujocoMatrix = FMatrix(
-			FVector(MjData->geom_xmat[BodyIndex*9 + 0], MjData->geom_xmat[BodyIndex*9 + 3], MjData->geom_xmat[BodyIndex*9 + 6]),  // X-axis
-			FVector(MjData->geom_xmat[BodyIndex*9 + 1], MjData->geom_xmat[BodyIndex*9 + 4], MjData->geom_xmat[BodyIndex*9 + 7]),  // Y-axis
-			FVector(MjData->geom_xmat[BodyIndex*9 + 2], MjData->geom_xmat[BodyIndex*9 + 5], MjData->geom_xmat[BodyIndex*9 + 8]),  // Z-axis
-			FVector::ZeroVector
-		);
+		for (const auto& MeshPair : SpawnedMeshes)
+		{
+			UMeshComponent* Mesh = MeshPair.Value;
+			if (!Mesh) continue;
 
-		FQuat Rotation = MujocoMatrix.ToQuat();
-		// Apply position and rotation updates
-		Mesh->SetWorldLocation(Position);
-		Mesh->SetWorldRotation(Rotation);
+			FVector Position;
+			FQuat Rotation;
+			GeomPose(MeshPair.Key, Position, Rotation);
+			Mesh->SetWorldLocationAndRotation(Position, Rotation);
+		}
+		UpdateGeomBatches(GeomBatches, InstanceTransforms, GeomPose);
 
+		// Stats get their own pass so the loops above stay branch-free
 		if (bLogStats)
 		{
-			UE_LOG(LogMujocoManager, Log, TEXT("%i: (%.5f, %.5f, %.5f), (%.5f, %.5f, %.5f)"), BodyIndex, Position.X, Position.Y, Position.Z, Rotation.X, Rotation.Y, Rotation.Z);
+			for (int32 Geom = 0; Geom < MjModel->ngeom; ++Geom)
+			{
+				FVector Position;
+				FQuat Rotation;
+				GeomPose(Geom, Position, Rotation);
+				UE_LOG(LogMujocoManager, Log, TEXT("%i: (%.5f, %.5f, %.5f), (%.5f, %.5f, %.5f)"), Geom, Position.X, Position.Y, Position.Z, Rotation.X, Rotation.Y, Rotation.Z);
+			}
 		}
-	}
+	});
 }
 
-void AMujocoManager::PrintBodyPosition() const
+void AMujocoManager::ApplyInterpolatedPosesToMeshes()
 {
-	if (!MjModel || !MjData)
+	Conversion.Dispatch([this](auto Axes)
 	{
-		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot print body position, model or data is missing."));
-		return;
+		using FAxes = decltype(Axes);
+
+		// The pose buffer blends in MuJoCo axes; the conversion is linear, so it commutes with the blend
+		auto GeomPose = [this](const int32 Geom, FVector& Position, FQuat& Rotation)
+		{
+			Position = MujocoConversion::ToUnrealPosition<FAxes>(PoseBuffer.GetPosition(Geom), Conversion.UnitScale);
+			Rotation = MujocoConversion::ToUnrealRotation<FAxes>(PoseBuffer.GetRotation(Geom));
+		};
+
+		for (const auto& MeshPair : SpawnedMeshes)
+		{
+			UMeshComponent* Mesh = MeshPair.Value;
+			if (!Mesh) continue;
+
+			FVector Position;
+			FQuat Rotation;
+			GeomPose(MeshPair.Key, Position, Rotation);
+			Mesh->SetWorldLocationAndRotation(Position, Rotation);
+		}
+		UpdateGeomBatches(GeomBatches, InstanceTransforms, GeomPose);
+	});
+}
+
+bool AMujocoManager::StartRecording(const FString& FilePath)
+{
+	if (!MjModel || !MjData)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot record trajectory. Model or data is missing."));
+		return false;
+	}
+
+	if (!TrajectoryWriter.Open(FilePath, *MujocoApi, MjModel))
+	{
+		return false;
+	}
+
+	// Include the starting state so playback begins where the recording did
+	TrajectoryWriter.Append(*MujocoApi, MjModel, MjData);
+	return true;
+}
+
+void AMujocoManager::StopRecording()
+{
+	TrajectoryWriter.Close();
+}
+
+bool AMujocoManager::StartHashLog(const FString& FilePath)
+{
+	if (!MjModel || !MjData)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot log state hashes. Model or data is missing."));
+		return false;
+	}
+
+	return Determinism.OpenLog(FilePath, MjModel);
+}
+
+void AMujocoManager::StopHashLog()
+{
+	Determinism.CloseLog();
+}
+
+bool AMujocoManager::StartDeterminismCheck(const FString& ReferencePath)
+{
+	if (!MjModel || !MjData)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot check determinism. Model or data is missing."));
+		return false;
+	}
+
+	return Determinism.LoadReference(ReferencePath, MjModel);
+}
+
+void AMujocoManager::StopDeterminismCheck()
+{
+	Determinism.ClearReference();
+}
+
+bool AMujocoManager::StartReplay(const FString& FilePath)
+{
+	if (!MjModel || !MjData)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot replay trajectory. Model or data is missing."));
+		return false;
+	}
+
+	StopRecording();
+	if (!TrajectoryReader.Open(FilePath, *MujocoApi, MjModel))
+	{
+		return false;
+	}
+
+	ReplayFrame = INDEX_NONE;
+	ReplayTime = ReplaySpeed >= 0.0 ? TrajectoryReader.GetStartTime() : TrajectoryReader.GetEndTime();
+	ApplyReplayFrame(TrajectoryReader.FindFrame(ReplayTime));
+	return true;
+}
+
+void AMujocoManager::StopReplay()
+{
+	TrajectoryReader.Close();
+	ReplayFrame = INDEX_NONE;
+}
+
+void AMujocoManager::SeekReplay(const double Time)
+{
+	if (!TrajectoryReader.IsOpen())
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("SeekReplay called without an active replay."));
+		return;
+	}
+
+	ReplayTime = FMath::Clamp(Time, TrajectoryReader.GetStartTime(), TrajectoryReader.GetEndTime());
+	ApplyReplayFrame(TrajectoryReader.FindFrame(ReplayTime));
+}
+
+void AMujocoManager::ApplyReplayFrame(const int64 FrameIndex)
+{
+	// Consecutive render frames often land on the same physics frame during slow-motion playback
+	if (FrameIndex == ReplayFrame)
+	{
+		return;
+	}
+
+	if (TrajectoryReader.ApplyFrame(FrameIndex, *MujocoApi, MjModel, MjData))
+	{
+		ReplayFrame = FrameIndex;
+		MujocoApi->Kinematics(MjModel, MjData);
+		ApplyGeomPosesToMeshes();
+	}
+}
+
+bool AMujocoManager::InitializeRollouts(const int32 NumRollouts)
+{
+	if (!MjModel)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot initialize rollouts. Model is not loaded."));
+		return false;
+	}
+
+	return RolloutPool.Initialize(DataPool, MjModel, NumRollouts);
+}
+
+bool AMujocoManager::EvaluateRollouts(const TArrayView<const double> Controls, const int32 Horizon, FMujocoRolloutCost Cost)
+{
+	if (!MjData || RolloutPool.GetModel() != MjModel)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot evaluate rollouts. Call InitializeRollouts after loading the model."));
+		return false;
+	}
+
+	return RolloutPool.Run(MjData, Controls, Horizon, Cost);
+}
+
+bool AMujocoManager::RewindToStep(const int64 Step)
+{
+	if (!MjModel || !MjData || !RewindBuffer.IsInitialized())
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot rewind. Enable rewind before loading the model."));
+		return false;
+	}
+
+	if (!RewindBuffer.Restore(Step, *MujocoApi, MjModel, MjData))
+	{
+		return false;
+	}
+
+	// Time runs backwards from here, which a recording cannot hold
+	if (TrajectoryWriter.IsOpen())
+	{
+		UE_LOG(LogMujocoManager, Log, TEXT("Rewind ends the trajectory recording."));
+		StopRecording();
+	}
+
+	SimulationStep = Step;
+	StepClock.DiscardBacklog();
+	ControlBuffer.Reset(MjData);
+	MujocoApi->Forward(MjModel, MjData);
+	PoseBuffer.Reset(MjData, SimulationStep);
+	ApplyGeomPosesToMeshes();
+
+	UE_LOG(LogMujocoManager, Log, TEXT("Rewound to step %lld (t=%.4f)"), Step, MjData->time);
+	return true;
+}
+
+bool AMujocoManager::RewindSeconds(const double Seconds)
+{
+	if (!MjModel || RewindBuffer.IsEmpty())
+	{
+		return false;
+	}
+
+	const int64 Steps = FMath::RoundToInt64(Seconds / MjModel->opt.timestep);
+	return RewindToStep(FMath::Max(SimulationStep - Steps, RewindBuffer.GetOldestStep()));
+}
+
+void AMujocoManager::GetRewindWindow(int64& OldestStep, int64& NewestStep) const
+{
+	OldestStep = RewindBuffer.GetOldestStep();
+	NewestStep = RewindBuffer.GetNewestStep();
+}
+
+void AMujocoManager::LogMemoryStats() const
+{
+	const FMujocoMemoryStats& Stats = MemoryTelemetry.GetStats();
+	UE_LOG(LogMujocoManager, Log, TEXT("Arena %lld bytes, peak %lld (stack %lld), peak contacts %d, peak constraints %d, overflows %d over %lld steps"),
+		Stats.ArenaBytes, Stats.PeakArenaBytes, Stats.PeakStackBytes, Stats.PeakContacts, Stats.PeakConstraints, Stats.Overflows, Stats.StepsObserved);
+}
+
+bool AMujocoManager::ResizeArena(const int64 ArenaBytes)
+{
+	if (!MjModel || !MjData || ArenaBytes <= 0)
+	{
+		return false;
+	}
+
+	if (static_cast<size_t>(ArenaBytes) == MjModel->narena)
+	{
+		return true;
+	}
+
+	// Carry the full state over to the reallocated data
+	TArray<mjtNum> State;
+	State.SetNumUninitialized(MujocoApi->GetStateSize(MjModel, mjSTATE_INTEGRATION));
+	MujocoApi->GetState(MjModel, MjData, State.GetData(), mjSTATE_INTEGRATION);
+
+	// Pooled instances were made with the old arena size; everything holding one returns it first
+	const int32 NumRollouts = RolloutPool.GetNumRollouts();
+	RolloutPool.Release();
+	for (UMujocoLidarComponent* Lidar : LidarSensors)
+	{
+		Lidar->Unbind(*DataPool);
+	}
+	DataPool->Release(MjModel, MjData);
+	DataPool->ReleaseModel(MjModel);
+
+	const int64 OldArenaBytes = static_cast<int64>(MjModel->narena);
+	MjModel->narena = static_cast<size_t>(ArenaBytes);
+	MjData = DataPool->Acquire(MjModel);
+	if (!MjData)
+	{
+		UE_LOG(LogMujocoManager, Error, TEXT("Failed to reallocate mjData with a %lld byte arena."), ArenaBytes);
+		MjModel->narena = static_cast<size_t>(OldArenaBytes);
+		MjData = DataPool->Acquire(MjModel);
+		if (!MjData)
+		{
+			return false;
+		}
+	}
+
+	MujocoApi->SetState(MjModel, MjData, State.GetData(), mjSTATE_INTEGRATION);
+	MujocoApi->Forward(MjModel, MjData);
+
+	if (NumRollouts > 0)
+	{
+		RolloutPool.Initialize(DataPool, MjModel, NumRollouts);
+	}
+	for (UMujocoLidarComponent* Lidar : LidarSensors)
+	{
+		Lidar->BindToModel(*MujocoApi, MjModel, *DataPool);
+	}
+
+	MemoryTelemetry.OnArenaResized(MjModel);
+
+	UE_LOG(LogMujocoManager, Log, TEXT("Resized mjData arena from %lld to %lld bytes (peak use %lld)."),
+		OldArenaBytes, static_cast<int64>(MjModel->narena), MemoryTelemetry.GetStats().PeakArenaBytes);
+	return static_cast<int64>(MjModel->narena) == ArenaBytes;
+}
+
+bool AMujocoManager::RightSizeArena()
+{
+	if (MemoryTelemetry.GetStats().StepsObserved == 0)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot right-size the arena before any step has been observed."));
+		return false;
+	}
+
+	LogMemoryStats();
+	return ResizeArena(MemoryTelemetry.GetRecommendedArenaBytes(ArenaHeadroom));
+}
+
+void AMujocoManager::ExchangeWithPolicy()
+{
+	// Write straight into the shared segment; the policy sees it once the sequence is published
+	const TArrayView<double> Observations = PolicyBridge.GetObservations();
+	Observations[0] = MjData->time;
+	FMemory::Memcpy(Observations.GetData() + 1, MjData->qpos, MjModel->nq * sizeof(double));
+	FMemory::Memcpy(Observations.GetData() + 1 + MjModel->nq, MjData->qvel, MjModel->nv * sizeof(double));
+
+	if (PolicyBridge.WaitForActions(PolicyBridge.Publish(), PolicyTimeoutMilliseconds * 0.001))
+	{
+		ControlBuffer.SetControls(PolicyBridge.GetActions());
+		if (!bPolicyResponding)
+		{
+			UE_LOG(LogMujocoManager, Log, TEXT("Policy '%s' is responding again."), *PolicyBridgeName);
+			bPolicyResponding = true;
+		}
+	}
+	else if (bPolicyResponding)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Policy '%s' did not answer within %.2f ms; keeping the previous controls."), *PolicyBridgeName, PolicyTimeoutMilliseconds);
+		bPolicyResponding = false;
+	}
+}
+
+void AMujocoManager::RegisterController(const TSharedRef<IMujocoController>& Controller)
+{
+	if (Controllers.Contains(Controller))
+	{
+		return;
+	}
+
+	Controllers.Add(Controller);
+	BoundControllers.Add(MjModel && Controller->Bind(MjModel));
+}
+
+void AMujocoManager::UnregisterController(const TSharedRef<IMujocoController>& Controller)
+{
+	const int32 Index = Controllers.Find(Controller);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (BoundControllers[Index])
+	{
+		Controller->Unbind();
+	}
+	Controllers.RemoveAt(Index);
+	BoundControllers.RemoveAt(Index);
+}
+
+FMujocoSensorBatch AMujocoManager::ResolveSensors(const TArray<FName>& Names) const
+{
+	TArray<FName> Missing;
+	FMujocoSensorBatch Batch = SensorTable.Resolve(Names, &Missing);
+	for (const FName Name : Missing)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Sensor '%s' not found in the model."), *Name.ToString());
+	}
+	return Batch;
+}
+
+void AMujocoManager::ReadSensors(const FMujocoSensorBatch& Batch, TArray<double>& OutValues) const
+{
+	OutValues.Reset(Batch.NumValues);
+	if (MjData && !SensorTable.Copy(MjData, Batch, OutValues))
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Sensor batch was resolved against a previous model. Resolve it again."));
+	}
+}
+
+void AMujocoManager::ReadSensor(const FMujocoSensorHandle& Sensor, TArray<double>& OutValues) const
+{
+	OutValues.Reset(Sensor.Dimension);
+	if (MjData && Sensor.IsValid() && !SensorTable.IsCurrent(Sensor))
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Sensor handle was resolved against a previous model. Find it again."));
+		return;
+	}
+	OutValues.Append(GetSensorView(Sensor));
+}
+
+void AMujocoManager::GetContacts(TArray<FMujocoContact>& OutContacts) const
+{
+	OutContacts.Reset(ContactQuery.GetContacts().Num());
+	OutContacts.Append(ContactQuery.GetContacts());
+}
+
+FMujocoContactPairStats AMujocoManager::GetContactPairStats(const int32 Filter) const
+{
+	if (Filter < 0 || Filter >= ContactQuery.GetNumPairFilters())
+	{
+		return FMujocoContactPairStats();
+	}
+	return ContactQuery.GetPairStats(Filter);
+}
+
+void AMujocoManager::UpdateDebugDraw()
+{
+	if (!bDebugDraw || !MjModel || !MjData)
+	{
+		if (DebugLineBatcher)
+		{
+			DebugLineBatcher->Flush();
+		}
+		return;
+	}
+
+	if (!DebugLineBatcher)
+	{
+		DebugLineBatcher = NewObject<ULineBatchComponent>(this, TEXT("MuJoCoDebugLines"));
+		DebugLineBatcher->RegisterComponent();
+	}
+
+	// Contacts are normally extracted per step; debug drawing only needs them once per frame
+	const bool bNeedContacts = bDebugDrawContacts || bDebugDrawContactForces;
+	if (bNeedContacts && !bExtractContacts)
+	{
+		ContactQuery.Extract(*MujocoApi, MjModel, MjData);
+	}
+
+	FMujocoDebugDrawOptions Options;
+	Options.bContacts = bDebugDrawContacts;
+	Options.bContactForces = bDebugDrawContactForces;
+	Options.bCentersOfMass = bDebugDrawCentersOfMass;
+	Options.bJointAxes = bDebugDrawJointAxes;
+	Options.Conversion = Conversion;
+	Options.ForceScale = DebugForceScale;
+	Options.MaxLines = DebugMaxLines;
+
+	DebugDraw.Build(MjModel, MjData, bNeedContacts ? &ContactQuery : nullptr, Options);
+	DebugDraw.Submit(DebugLineBatcher);
+}
+
+void AMujocoManager::RegisterLidar(UMujocoLidarComponent* Lidar)
+{
+	if (!Lidar || LidarSensors.Contains(Lidar))
+	{
+		return;
+	}
+
+	LidarSensors.Add(Lidar);
+	if (MjModel)
+	{
+		Lidar->BindToModel(*MujocoApi, MjModel, *DataPool);
+	}
+}
+
+void AMujocoManager::UnregisterLidar(UMujocoLidarComponent* Lidar)
+{
+	if (Lidar && LidarSensors.Remove(Lidar) > 0)
+	{
+		Lidar->Unbind(*DataPool);
+	}
+}
+
+void AMujocoManager::ScanLidarSensors()
+{
+	if (LidarSensors.IsEmpty() || !MjData)
+	{
+		return;
+	}
+
+	const FMujocoAPI& Api = *MujocoApi;
+	ParallelFor(LidarSensors.Num(), [this, &Api](const int32 Index)
+	{
+		LidarSensors[Index]->Scan(Api, MjData);
+	});
+}
+
+void AMujocoManager::RegisterDepthCamera(UMujocoDepthCameraComponent* Camera)
+{
+	if (!Camera || DepthCameras.Contains(Camera))
+	{
+		return;
+	}
+
+	DepthCameras.Add(Camera);
+	if (MjModel)
+	{
+		if (!RayTracer.IsBound())
+		{
+			RayTracer.BindToModel(MujocoApi, MjModel);
+		}
+		Camera->BindToModel(*MujocoApi, MjModel);
+	}
+}
+
+void AMujocoManager::UnregisterDepthCamera(UMujocoDepthCameraComponent* Camera)
+{
+	if (Camera && DepthCameras.Remove(Camera) > 0)
+	{
+		Camera->Unbind();
+	}
+}
+
+void AMujocoManager::RenderDepthCameras()
+{
+	if (DepthCameras.IsEmpty() || !MjData || !RayTracer.IsBound())
+	{
+		return;
+	}
+
+	// Each camera already spreads its tiles over the task graph
+	RayTracer.Prepare(MjData);
+	for (UMujocoDepthCameraComponent* Camera : DepthCameras)
+	{
+		Camera->Render(RayTracer, MjData);
+	}
+}
+
+void AMujocoManager::PrintBodyPosition() const
+{
+	if (!MjModel || !MjData)
+	{
+		UE_LOG(LogMujocoManager, Warning, TEXT("Cannot print body position, model or data is missing."));
+		return;
 	}
 
 	// Ensure positions are updated before reading xpos
 	MujocoApi->Forward(MjModel, MjData);  // Updates all kinematic data
 
-	// Print world position of the first body (ignoring world body at index 0)
-	if (MjModel->nbody > 1)
+	// Print world position of the tracked body (the first body after the world body by default)
+	if (TrackedBody.IsValid())
 	{
-		constexpr int BodyIndex = 1; // First movable body
+		const int32 BodyIndex = TrackedBody.Id;
 		const FVector Position(
 			MjData->xpos[BodyIndex * 3],     // X position
 			MjData->xpos[BodyIndex * 3 + 1], // Y position
@@ -574,12 +1472,29 @@ void AMujocoManager::PrintBodyPosition() const
 	}
 }
 
-void AMujocoManager::ResetSimulation() const
+void AMujocoManager::ResetSimulation()
 {
 	UE_LOG(LogMujocoManager, Log, TEXT("ResetSimulation"));
 	if (MjModel && MjData)
 	{
+		if (TrajectoryWriter.IsOpen())
+		{
+			UE_LOG(LogMujocoManager, Log, TEXT("Reset ends the trajectory recording."));
+			StopRecording();
+		}
+
 		MujocoApi->ResetData(MjModel, MjData);
+		SimulationStep = 0;
+		StepClock.DiscardBacklog();
+		ControlBuffer.Reset(MjData);
+		MujocoApi->Forward(MjModel, MjData);
+		PoseBuffer.Reset(MjData, SimulationStep);
+
+		if (RewindBuffer.IsInitialized())
+		{
+			RewindBuffer.Clear();
+			RewindBuffer.Capture(*MujocoApi, MjModel, MjData, SimulationStep);
+		}
 		UE_LOG(LogMujocoManager, Log, TEXT("Simulation reset."));
 	}
 }
@@ -589,6 +1504,10 @@ void AMujocoManager::BeginPlay()
 {
 	UE_LOG(LogMujocoManager, Log, TEXT("BeginPlay"));
 	Super::BeginPlay();
+	if (bEnableStateStream)
+	{
+		StateStreamer.Start(StreamPort, bStreamAllowRemote, StreamMaxRateHz, StreamQueueDepth);
+	}
 	if (!MuJoCoXMLPath.IsEmpty())
 	{
 		LoadModel();
@@ -596,6 +1515,13 @@ void AMujocoManager::BeginPlay()
 	{
 		UE_LOG(LogMujocoManager, Warning, TEXT("Model Path is empty :("));
 	}
+
+	UMujocoWorldSubsystem* Subsystem = GetWorld()->GetSubsystem<UMujocoWorldSubsystem>();
+	if (bStepOnWorldSubsystem && Subsystem)
+	{
+		Subsystem->RegisterManager(this);
+		bSteppedBySubsystem = true;
+	}
 }
 
 // Called every frame
@@ -603,36 +1529,251 @@ void AMujocoManager::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (MjModel && MjData && bStepSimulation)
+	if (!bSteppedBySubsystem)
+	{
+		FVector ViewLocation;
+		if (UMujocoWorldSubsystem::GetViewLocation(GetWorld(), ViewLocation))
+		{
+			UpdateSimulationLOD(ViewLocation);
+		}
+		AdvanceSimulation(DeltaTime);
+		SyncToScene(DeltaTime);
+	}
+}
+
+void AMujocoManager::UpdateSimulationLOD(const FVector& ViewLocation)
+{
+	if (!MjModel || !MjData)
+	{
+		return;
+	}
+
+	// The world body's subtree center of mass is the center of mass of the whole model
+	const FVector Center = Conversion.ToUnrealPosition(MjData->subtree_com);
+	const EMujocoSimulationLOD Previous = SimulationLOD.GetLevel();
+	if (LODSettings.bEnabled)
+	{
+		SimulationLOD.Update(LODSettings, FVector::Dist(Center, ViewLocation));
+	}
+	else
+	{
+		SimulationLOD.ForceNear();
+	}
+
+	const EMujocoSimulationLOD Level = SimulationLOD.GetLevel();
+	if (Level == Previous)
+	{
+		return;
+	}
+
+	if (Level == EMujocoSimulationLOD::Far && LODSettings.bFreezeWhenFar)
+	{
+		SimulationLOD.Freeze();
+	}
+	else
+	{
+		SimulationLOD.Thaw();
+	}
+
+	// Time owed at the old rate does not carry over, and blending restarts from the current state
+	StepClock.DiscardBacklog();
+	PoseBuffer.Reset(MjData, SimulationStep);
+	UE_LOG(LogMujocoManager, Verbose, TEXT("Simulation LOD %s -> %s%s"), *UEnum::GetValueAsString(Previous), *UEnum::GetValueAsString(Level), SimulationLOD.IsFrozen() ? TEXT(" (frozen)") : TEXT(""));
+}
+
+void AMujocoManager::AdvanceSimulation(const float DeltaTime)
+{
+	StepsTakenThisFrame = 0;
+	LODStepsSavedPerSecond = 0.0;
+	if (!MjModel || !MjData || !bStepSimulation || TrajectoryReader.IsOpen())
 	{
-		AccumulatedTime += DeltaTime;
+		return;
+	}
+
+	const double Timestep = MjModel->opt.timestep;
+	const double Rate = SimulationLOD.GetStepRate(LODSettings);
+	if (Timestep > 0.0 && DeltaTime > 0.0)
+	{
+		// As fast as possible has no nominal rate; the achieved one stands for Rate of it
+		const double FullStepsPerSecond = StepMode == EMujocoStepMode::AsFastAsPossible ? StepClock.GetStats().StepsPerSecond / FMath::Max(Rate, UE_KINDA_SMALL_NUMBER)
+			: (StepMode == EMujocoStepMode::Scaled ? TimeScale : 1.0) / Timestep;
+		LODStepsSavedPerSecond = FullStepsPerSecond * (1.0 - Rate);
+	}
+	if (SimulationLOD.IsFrozen())
+	{
+		return;
+	}
+
+	// As fast as possible runs until the budget, cut by the LOD rate, is spent; the step count is unbounded
+	const int32 Steps = StepClock.BeginFrame(DeltaTime, Timestep, StepMode, TimeScale, MaxStepsPerFrame, Rate);
+	const double Deadline = FPlatformTime::Seconds() + FrameBudgetMilliseconds * Rate / 1000.0;
+
+	while (StepsTakenThisFrame < Steps)
+	{
+		// A diverged or failed step will not recover by retrying within the frame
+		if (!StepSimulation())
+		{
+			break;
+		}
+		++StepsTakenThisFrame;
 
-		while (AccumulatedTime >= FixedTimeStep)
+		if (StepMode == EMujocoStepMode::AsFastAsPossible && FPlatformTime::Seconds() >= Deadline)
 		{
-			StepSimulation();
-			AccumulatedTime -= FixedTimeStep;
+			break;
+		}
+	}
+	StepClock.EndFrame(StepsTakenThisFrame, Timestep);
+}
+
+void AMujocoManager::SyncToScene(const float DeltaTime)
+{
+	if (PendingArenaBytes > 0)
+	{
+		const int64 ArenaBytes = PendingArenaBytes;
+		PendingArenaBytes = 0;
+		LogMemoryStats();
+		ResizeArena(ArenaBytes);
+	}
+
+	if (MjModel && MjData && TrajectoryReader.IsOpen())
+	{
+		const double StartTime = TrajectoryReader.GetStartTime();
+		const double EndTime = TrajectoryReader.GetEndTime();
+		ReplayTime += DeltaTime * ReplaySpeed;
+
+		if (bLoopReplay && EndTime > StartTime)
+		{
+			ReplayTime = StartTime + FMath::Fmod(ReplayTime - StartTime + (EndTime - StartTime), EndTime - StartTime);
+		}
+		else
+		{
+			ReplayTime = FMath::Clamp(ReplayTime, StartTime, EndTime);
+		}
+
+		ApplyReplayFrame(TrajectoryReader.FindFrame(ReplayTime));
+		return;
+	}
+
+	if (MjModel && MjData && bStepSimulation && SimulationLOD.ShouldSync())
+	{
+		if (StepsTakenThisFrame > 0)
+		{
+			ScanLidarSensors();
+			RenderDepthCameras();
 		}
 		// Sync Unreal Objects with Mujoco data
 		UpdateMuJoCoObjects(); 
 	}
+
+	UpdateDebugDraw();
 }
 
 
 void AMujocoManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	UE_LOG(LogMujocoManager, Log, TEXT("EndPlay"));
+	if (bSteppedBySubsystem)
+	{
+		if (UMujocoWorldSubsystem* Subsystem = GetWorld()->GetSubsystem<UMujocoWorldSubsystem>())
+		{
+			Subsystem->UnregisterManager(this);
+		}
+		bSteppedBySubsystem = false;
+	}
+	StateStreamer.Shutdown();
+	UnloadModel();
+	Super::EndPlay(EndPlayReason);
+}
+
+void AMujocoManager::Destroyed()
+{
+	// After EndPlay this finds nothing left to free
+	UnloadModel();
+	Super::Destroyed();
+}
+
+void AMujocoManager::UnbindModel(const bool bKeepSettings)
+{
+	for (UMujocoLidarComponent* Lidar : LidarSensors)
+	{
+		Lidar->Unbind(*DataPool);
+	}
+	for (UMujocoDepthCameraComponent* Camera : DepthCameras)
+	{
+		Camera->Unbind();
+	}
+	RayTracer.Unbind();
+	SensorTable.Reset();
+	StreamedSensorBatch = FMujocoSensorBatch();
+	ContactQuery.Reset();
+	PoseBuffer.Release();
+	NameIndex.Reset();
+	ControlBuffer.Release();
+	PolicyBridge.Close();
+	for (int32 Index = 0; Index < Controllers.Num(); ++Index)
+	{
+		// Left bound, a controller carries its settings over to the next Bind
+		if (!bKeepSettings)
+		{
+			Controllers[Index]->Unbind();
+		}
+		BoundControllers[Index] = false;
+	}
+	ControlActuator = FMujocoActuatorHandle();
+	TrackedBody = FMujocoBodyHandle();
+
+	StopRecording();
+	StopReplay();
+	StopHashLog();
+	StopDeterminismCheck();
+	RolloutPool.Release();
+	RewindBuffer.Release();
+	SimulationLOD.Release();
+}
+
+void AMujocoManager::UnloadModel()
+{
+	UnbindModel();
+
 	if (MjData)
 	{
-		MujocoApi->FreeData(MjData);
+		DataPool->Release(MjModel, MjData);
 		MjData = nullptr;
 	}
 
 	if (MjModel)
 	{
+		DataPool->ReleaseModel(MjModel);
 		MujocoApi->FreeModel(MjModel);
 		MjModel = nullptr;
 	}
 
-	Super::EndPlay(EndPlayReason);
+	SceneBuilder.Reset();
+	DestroySpawnedMeshes();
+}
+
+void AMujocoManager::DestroySpawnedMeshes()
+{
+	for (const auto& MeshPair : SpawnedMeshes)
+	{
+		DestroySpawnedMesh(MeshPair.Value);
+	}
+	SpawnedMeshes.Reset();
+
+	for (const FMujocoGeomBatch& Batch : GeomBatches)
+	{
+		DestroySpawnedMesh(Batch.Component);
+	}
+	GeomBatches.Reset();
+	HeightfieldMeshes.Reset();
+}
+
+void AMujocoManager::DestroySpawnedMesh(UMeshComponent* Mesh)
+{
+	if (Mesh)
+	{
+		RemoveInstanceComponent(Mesh);
+		Mesh->DestroyComponent();
+	}
 }
 
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoMemoryTelemetry.h"
+
+
+void FMujocoMemoryTelemetry::Reset(const mjModel* Model)
+{
+	Stats = FMujocoMemoryStats();
+	Stats.ArenaBytes = Model ? static_cast<int64>(Model->narena) : 0;
+	InitialArenaBytes = Stats.ArenaBytes;
+	LastOverflowCount = 0;
+	bLastStepOverflowed = false;
+}
+
+void FMujocoMemoryTelemetry::OnArenaResized(const mjModel* Model)
+{
+	Stats.ArenaBytes = Model ? static_cast<int64>(Model->narena) : 0;
+
+	// Fresh mjData starts with cleared warning counters
+	LastOverflowCount = 0;
+	bLastStepOverflowed = false;
+}
+
+void FMujocoMemoryTelemetry::Observe(const mjData* Data)
+{
+	if (!Data)
+	{
+		return;
+	}
+
+	Stats.PeakArenaBytes = FMath::Max(Stats.PeakArenaBytes, static_cast<int64>(Data->maxuse_arena));
+	Stats.PeakStackBytes = FMath::Max(Stats.PeakStackBytes, static_cast<int64>(Data->maxuse_stack));
+	Stats.PeakContacts = FMath::Max(Stats.PeakContacts, Data->maxuse_con);
+	Stats.PeakConstraints = FMath::Max(Stats.PeakConstraints, Data->maxuse_efc);
+	++Stats.StepsObserved;
+
+	// Warning counters are cumulative until the next reset, so compare against the last step
+	const int32 OverflowCount = Data->warning[mjWARN_CONTACTFULL].number + Data->warning[mjWARN_CNSTRFULL].number;
+	bLastStepOverflowed = OverflowCount > LastOverflowCount;
+	if (bLastStepOverflowed)
+	{
+		++Stats.Overflows;
+	}
+	LastOverflowCount = OverflowCount;
+}
+
+int64 FMujocoMemoryTelemetry::GetRecommendedArenaBytes(const double Headroom) const
+{
+	constexpr int64 PageBytes = 64 * 1024;
+	const int64 Peak = FMath::Max(Stats.PeakArenaBytes, Stats.PeakStackBytes);
+	const int64 Target = static_cast<int64>(static_cast<double>(Peak) * (1.0 + FMath::Max(Headroom, 0.0)));
+	return FMath::Max3<int64>(Align(Target, PageBytes), PageBytes, InitialArenaBytes);
+}
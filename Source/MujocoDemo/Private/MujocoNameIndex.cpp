@@ -0,0 +1,329 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoNameIndex.h"
+
+#include "Algo/Unique.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoNames);
+
+
+namespace
+{
+	/** Seeds tried for one bucket before the slot table is grown */
+	constexpr uint32 MaxSeedAttempts = 1u << 16;
+
+	/** Average keys per bucket; larger buckets mean fewer seeds but a longer search at build time */
+	constexpr int32 KeysPerBucket = 3;
+
+	uint32 HashName(const FAnsiStringView Name, const uint32 Seed)
+	{
+		// FNV-1a followed by the murmur3 finalizer, so nearby seeds give unrelated slots
+		uint32 Hash = 2166136261u ^ Seed;
+		for (const ANSICHAR Char : Name)
+		{
+			Hash ^= static_cast<uint8>(Char);
+			Hash *= 16777619u;
+		}
+		Hash ^= Hash >> 16;
+		Hash *= 0x85ebca6bu;
+		Hash ^= Hash >> 13;
+		Hash *= 0xc2b2ae35u;
+		Hash ^= Hash >> 16;
+		return Hash;
+	}
+}
+
+
+const int* FMujocoNameIndex::GetNameAddresses(const mjModel* Model, const mjtObj Type, int32& OutCount)
+{
+	OutCount = 0;
+	if (!Model)
+	{
+		return nullptr;
+	}
+
+	switch (Type)
+	{
+	case mjOBJ_BODY:
+	case mjOBJ_XBODY:	OutCount = Model->nbody;	return Model->name_bodyadr;
+	case mjOBJ_JOINT:	OutCount = Model->njnt;		return Model->name_jntadr;
+	case mjOBJ_GEOM:	OutCount = Model->ngeom;	return Model->name_geomadr;
+	case mjOBJ_SITE:	OutCount = Model->nsite;	return Model->name_siteadr;
+	case mjOBJ_CAMERA:	OutCount = Model->ncam;		return Model->name_camadr;
+	case mjOBJ_LIGHT:	OutCount = Model->nlight;	return Model->name_lightadr;
+	case mjOBJ_FLEX:	OutCount = Model->nflex;	return Model->name_flexadr;
+	case mjOBJ_MESH:	OutCount = Model->nmesh;	return Model->name_meshadr;
+	case mjOBJ_SKIN:	OutCount = Model->nskin;	return Model->name_skinadr;
+	case mjOBJ_HFIELD:	OutCount = Model->nhfield;	return Model->name_hfieldadr;
+	case mjOBJ_TEXTURE:	OutCount = Model->ntex;		return Model->name_texadr;
+	case mjOBJ_MATERIAL:	OutCount = Model->nmat;		return Model->name_matadr;
+	case mjOBJ_PAIR:	OutCount = Model->npair;	return Model->name_pairadr;
+	case mjOBJ_EXCLUDE:	OutCount = Model->nexclude;	return Model->name_excludeadr;
+	case mjOBJ_EQUALITY:	OutCount = Model->neq;		return Model->name_eqadr;
+	case mjOBJ_TENDON:	OutCount = Model->ntendon;	return Model->name_tendonadr;
+	case mjOBJ_ACTUATOR:	OutCount = Model->nu;		return Model->name_actuatoradr;
+	case mjOBJ_SENSOR:	OutCount = Model->nsensor;	return Model->name_sensoradr;
+	case mjOBJ_NUMERIC:	OutCount = Model->nnumeric;	return Model->name_numericadr;
+	case mjOBJ_TEXT:	OutCount = Model->ntext;	return Model->name_textadr;
+	case mjOBJ_TUPLE:	OutCount = Model->ntuple;	return Model->name_tupleadr;
+	case mjOBJ_KEY:		OutCount = Model->nkey;		return Model->name_keyadr;
+	case mjOBJ_PLUGIN:	OutCount = Model->nplugin;	return Model->name_pluginadr;
+	default:			return nullptr;
+	}
+}
+
+void FMujocoNameIndex::Build(const mjModel* InModel)
+{
+	Reset();
+	if (!InModel)
+	{
+		return;
+	}
+	Model = InModel;
+
+	for (int32 Type = 0; Type < mjNOBJECT; ++Type)
+	{
+		int32 Count = 0;
+		const int* NameAddresses = GetNameAddresses(Model, static_cast<mjtObj>(Type), Count);
+		if (NameAddresses && Count > 0)
+		{
+			BuildTable(Tables[Type], NameAddresses, Count);
+		}
+	}
+}
+
+void FMujocoNameIndex::Reset()
+{
+	for (FTable& Table : Tables)
+	{
+		Table.Seeds.Empty();
+		Table.Slots.Empty();
+		Table.CaseCollisions.Empty();
+	}
+	Model = nullptr;
+}
+
+void FMujocoNameIndex::BuildTable(FTable& Table, const int* NameAddresses, const int32 Count) const
+{
+	// Collect named objects; like mj_name2id the first of any repeated name wins
+	TArray<int32> Keys;
+	Keys.Reserve(Count);
+	for (int32 Id = 0; Id < Count; ++Id)
+	{
+		if (Model->names[NameAddresses[Id]] != '\0')
+		{
+			Keys.Add(Id);
+		}
+	}
+
+	Keys.Sort([this, NameAddresses](const int32 A, const int32 B)
+	{
+		const int32 Order = FCStringAnsi::Strcmp(Model->names + NameAddresses[A], Model->names + NameAddresses[B]);
+		return Order != 0 ? Order < 0 : A < B;
+	});
+	Keys.SetNum(Algo::Unique(Keys, [this, NameAddresses](const int32 A, const int32 B)
+	{
+		return FCStringAnsi::Strcmp(Model->names + NameAddresses[A], Model->names + NameAddresses[B]) == 0;
+	}));
+
+	if (Keys.IsEmpty())
+	{
+		return;
+	}
+
+	// FName compares without case, so names equal but for case cannot be told apart through one
+	TArray<int32> CaseOrder = Keys;
+	CaseOrder.Sort([this, NameAddresses](const int32 A, const int32 B)
+	{
+		return FCStringAnsi::Stricmp(Model->names + NameAddresses[A], Model->names + NameAddresses[B]) < 0;
+	});
+	Table.CaseCollisions.Init(false, Count);
+	for (int32 i = 1; i < CaseOrder.Num(); ++i)
+	{
+		const ANSICHAR* Previous = Model->names + NameAddresses[CaseOrder[i - 1]];
+		const ANSICHAR* Current = Model->names + NameAddresses[CaseOrder[i]];
+		if (FCStringAnsi::Stricmp(Previous, Current) == 0)
+		{
+			Table.CaseCollisions[CaseOrder[i - 1]] = true;
+			Table.CaseCollisions[CaseOrder[i]] = true;
+			UE_LOG(LogMujocoNames, Warning, TEXT("MuJoCo names '%hs' and '%hs' differ only in case; look them up by string, not FName."), Previous, Current);
+		}
+	}
+
+	const int32 NumBuckets = FMath::DivideAndRoundUp(Keys.Num(), KeysPerBucket);
+	TArray<TArray<int32>> Buckets;
+	Buckets.SetNum(NumBuckets);
+	for (const int32 Id : Keys)
+	{
+		Buckets[HashName(Model->names + NameAddresses[Id], 0) % NumBuckets].Add(Id);
+	}
+
+	// Place the largest buckets first while the table is still mostly empty
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumBuckets);
+	for (int32 i = 0; i < NumBuckets; ++i)
+	{
+		Order[i] = i;
+	}
+	Order.Sort([&Buckets](const int32 A, const int32 B) { return Buckets[A].Num() > Buckets[B].Num(); });
+
+	int32 NumSlots = Keys.Num() + Keys.Num() / 4 + 1;
+	TArray<int32, TInlineAllocator<16>> Placed;
+	for (;;)
+	{
+		Table.Seeds.Init(0, NumBuckets);
+		Table.Slots.Init(INDEX_NONE, NumSlots);
+
+		bool bPlacedAll = true;
+		for (const int32 Bucket : Order)
+		{
+			const TArray<int32>& Ids = Buckets[Bucket];
+			if (Ids.IsEmpty())
+			{
+				break;
+			}
+
+			bool bPlaced = false;
+			for (uint32 Seed = 1; Seed <= MaxSeedAttempts && !bPlaced; ++Seed)
+			{
+				Placed.Reset();
+				bPlaced = true;
+				for (const int32 Id : Ids)
+				{
+					const int32 Slot = HashName(Model->names + NameAddresses[Id], Seed) % NumSlots;
+					if (Table.Slots[Slot] != INDEX_NONE)
+					{
+						bPlaced = false;
+						break;
+					}
+					Table.Slots[Slot] = Id;
+					Placed.Add(Slot);
+				}
+
+				if (bPlaced)
+				{
+					Table.Seeds[Bucket] = Seed;
+				}
+				else
+				{
+					for (const int32 Slot : Placed)
+					{
+						Table.Slots[Slot] = INDEX_NONE;
+					}
+				}
+			}
+
+			if (!bPlaced)
+			{
+				bPlacedAll = false;
+				break;
+			}
+		}
+
+		if (bPlacedAll)
+		{
+			return;
+		}
+
+		NumSlots += NumSlots / 4 + 1;
+	}
+}
+
+int32 FMujocoNameIndex::FindId(const mjtObj Type, const FAnsiStringView Name) const
+{
+	if (!Model || Type < 0 || Type >= mjNOBJECT || Name.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+
+	const FTable& Table = Tables[Type];
+	if (Table.Slots.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+
+	const uint32 Seed = Table.Seeds[HashName(Name, 0) % Table.Seeds.Num()];
+	if (Seed == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Id = Table.Slots[HashName(Name, Seed) % Table.Slots.Num()];
+	if (Id == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	// The slot holds whichever key hashed there; confirm it is this one
+	int32 Count = 0;
+	const int* NameAddresses = GetNameAddresses(Model, Type, Count);
+	return Name.Equals(FAnsiStringView(Model->names + NameAddresses[Id])) ? Id : INDEX_NONE;
+}
+
+int32 FMujocoNameIndex::FindId(const mjtObj Type, const FString& Name) const
+{
+	const FTCHARToUTF8 Utf8Name(*Name, Name.Len());
+	return FindId(Type, FAnsiStringView(Utf8Name.Get(), Utf8Name.Length()));
+}
+
+int32 FMujocoNameIndex::FindId(const mjtObj Type, const FName Name) const
+{
+	if (Name.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	TStringBuilder<FName::StringBufferSize> NameString;
+	Name.ToString(NameString);
+	const FTCHARToUTF8 Utf8Name(NameString.ToString(), NameString.Len());
+	const int32 Id = FindId(Type, FAnsiStringView(Utf8Name.Get(), Utf8Name.Length()));
+
+	// The FName's spelling is whichever case was registered first, so it may name the other object
+	const FTable& Table = Tables[Type];
+	if (Id != INDEX_NONE && Table.CaseCollisions.IsValidIndex(Id) && Table.CaseCollisions[Id])
+	{
+		UE_LOG(LogMujocoNames, Warning, TEXT("'%s' is ambiguous as an FName; another object differs from it only in case."), NameString.ToString());
+		return INDEX_NONE;
+	}
+	return Id;
+}
+
+FMujocoBodyHandle FMujocoNameIndex::FindBody(const FName Name) const
+{
+	FMujocoBodyHandle Handle;
+	Handle.Id = FindId(mjOBJ_BODY, Name);
+	return Handle;
+}
+
+FMujocoJointHandle FMujocoNameIndex::FindJoint(const FName Name) const
+{
+	FMujocoJointHandle Handle;
+	Handle.Id = FindId(mjOBJ_JOINT, Name);
+	if (Handle.IsValid())
+	{
+		Handle.QposAddress = Model->jnt_qposadr[Handle.Id];
+		Handle.DofAddress = Model->jnt_dofadr[Handle.Id];
+	}
+	return Handle;
+}
+
+FMujocoActuatorHandle FMujocoNameIndex::FindActuator(const FName Name) const
+{
+	FMujocoActuatorHandle Handle;
+	Handle.Id = FindId(mjOBJ_ACTUATOR, Name);
+	return Handle;
+}
+
+FMujocoSiteHandle FMujocoNameIndex::FindSite(const FName Name) const
+{
+	FMujocoSiteHandle Handle;
+	Handle.Id = FindId(mjOBJ_SITE, Name);
+	return Handle;
+}
+
+FMujocoGeomHandle FMujocoNameIndex::FindGeom(const FName Name) const
+{
+	FMujocoGeomHandle Handle;
+	Handle.Id = FindId(mjOBJ_GEOM, Name);
+	return Handle;
+}
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoPoseBuffer.h"
+
+#include "MujocoConversion.h"
+
+
+void FMujocoPoseBuffer::FFrame::SetNum(const int32 Num)
+{
+	for (TArray<double>* Stream : {&PX, &PY, &PZ, &QW, &QX, &QY, &QZ})
+	{
+		Stream->SetNumZeroed(Num);
+	}
+}
+
+void FMujocoPoseBuffer::FFrame::Empty()
+{
+	for (TArray<double>* Stream : {&PX, &PY, &PZ, &QW, &QX, &QY, &QZ})
+	{
+		Stream->Empty();
+	}
+}
+
+void FMujocoPoseBuffer::Initialize(const mjModel* Model, const mjData* Data, const int64 Step)
+{
+	Release();
+	if (!Model || !Data || Model->ngeom == 0)
+	{
+		return;
+	}
+
+	NumGeoms = Model->ngeom;
+	Frames[0].SetNum(NumGeoms);
+	Frames[1].SetNum(NumGeoms);
+	Blended.SetNum(NumGeoms);
+	Reset(Data, Step);
+}
+
+void FMujocoPoseBuffer::Release()
+{
+	Frames[0].Empty();
+	Frames[1].Empty();
+	Blended.Empty();
+	Current = 0;
+	NumGeoms = 0;
+	CurrentStep = INDEX_NONE;
+}
+
+void FMujocoPoseBuffer::Capture(const mjData* Data, const int64 Step)
+{
+	if (!IsInitialized())
+	{
+		return;
+	}
+
+	Current ^= 1;
+	Fill(Frames[Current], Data);
+	CurrentStep = Step;
+}
+
+void FMujocoPoseBuffer::Reset(const mjData* Data, const int64 Step)
+{
+	if (!IsInitialized())
+	{
+		return;
+	}
+
+	Fill(Frames[Current], Data);
+	Frames[Current ^ 1] = Frames[Current];
+	Blended = Frames[Current];
+	CurrentStep = Step;
+}
+
+void FMujocoPoseBuffer::Fill(FFrame& Frame, const mjData* Data) const
+{
+	for (int32 Geom = 0; Geom < NumGeoms; ++Geom)
+	{
+		const mjtNum* Position = Data->geom_xpos + Geom * 3;
+		Frame.PX[Geom] = Position[0];
+		Frame.PY[Geom] = Position[1];
+		Frame.PZ[Geom] = Position[2];
+
+		// Still in MuJoCo axes; the manager converts when applying
+		const FQuat Rotation = MujocoConversion::MatrixToQuat(Data->geom_xmat + Geom * 9);
+		Frame.QW[Geom] = Rotation.W;
+		Frame.QX[Geom] = Rotation.X;
+		Frame.QY[Geom] = Rotation.Y;
+		Frame.QZ[Geom] = Rotation.Z;
+	}
+}
+
+void FMujocoPoseBuffer::Blend(const double Alpha)
+{
+	if (!IsInitialized())
+	{
+		return;
+	}
+
+	const FFrame& From = Frames[Current ^ 1];
+	const FFrame& To = Frames[Current];
+	const double T = FMath::Clamp(Alpha, 0.0, 1.0);
+	const double S = 1.0 - T;
+
+	// Restrict-qualified locals keep the compiler from assuming the streams alias
+	const double* RESTRICT FromPX = From.PX.GetData();
+	const double* RESTRICT FromPY = From.PY.GetData();
+	const double* RESTRICT FromPZ = From.PZ.GetData();
+	const double* RESTRICT ToPX = To.PX.GetData();
+	const double* RESTRICT ToPY = To.PY.GetData();
+	const double* RESTRICT ToPZ = To.PZ.GetData();
+	double* RESTRICT OutPX = Blended.PX.GetData();
+	double* RESTRICT OutPY = Blended.PY.GetData();
+	double* RESTRICT OutPZ = Blended.PZ.GetData();
+	for (int32 Geom = 0; Geom < NumGeoms; ++Geom)
+	{
+		OutPX[Geom] = S * FromPX[Geom] + T * ToPX[Geom];
+		OutPY[Geom] = S * FromPY[Geom] + T * ToPY[Geom];
+		OutPZ[Geom] = S * FromPZ[Geom] + T * ToPZ[Geom];
+	}
+
+	// Normalized lerp along the shorter arc. Between consecutive steps the rotation is a few
+	// degrees at most, where this matches slerp to well under a pixel and stays branch-free.
+	const double* RESTRICT FromQW = From.QW.GetData();
+	const double* RESTRICT FromQX = From.QX.GetData();
+	const double* RESTRICT FromQY = From.QY.GetData();
+	const double* RESTRICT FromQZ = From.QZ.GetData();
+	const double* RESTRICT ToQW = To.QW.GetData();
+	const double* RESTRICT ToQX = To.QX.GetData();
+	const double* RESTRICT ToQY = To.QY.GetData();
+	const double* RESTRICT ToQZ = To.QZ.GetData();
+	double* RESTRICT OutQW = Blended.QW.GetData();
+	double* RESTRICT OutQX = Blended.QX.GetData();
+	double* RESTRICT OutQY = Blended.QY.GetData();
+	double* RESTRICT OutQZ = Blended.QZ.GetData();
+	for (int32 Geom = 0; Geom < NumGeoms; ++Geom)
+	{
+		const double Dot = FromQW[Geom] * ToQW[Geom] + FromQX[Geom] * ToQX[Geom] + FromQY[Geom] * ToQY[Geom] + FromQZ[Geom] * ToQZ[Geom];
+		const double TSigned = Dot < 0.0 ? -T : T;
+		const double W = S * FromQW[Geom] + TSigned * ToQW[Geom];
+		const double X = S * FromQX[Geom] + TSigned * ToQX[Geom];
+		const double Y = S * FromQY[Geom] + TSigned * ToQY[Geom];
+		const double Z = S * FromQZ[Geom] + TSigned * ToQZ[Geom];
+		const double InvLength = 1.0 / FMath::Sqrt(W * W + X * X + Y * Y + Z * Z);
+		OutQW[Geom] = W * InvLength;
+		OutQX[Geom] = X * InvLength;
+		OutQY[Geom] = Y * InvLength;
+		OutQZ[Geom] = Z * InvLength;
+	}
+}
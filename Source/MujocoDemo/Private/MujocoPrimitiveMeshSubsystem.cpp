@@ -0,0 +1,434 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoPrimitiveMeshSubsystem.h"
+
+#include "MaterialDomain.h"
+#include "MeshDescription.h"
+#include "MujocoConversion.h"
+#include "StaticMeshAttributes.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/Material.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoMeshes);
+
+
+namespace
+{
+	/** Vertices around the circumference of round shapes */
+	constexpr int32 CircleSegments = 32;
+
+	/** Rings of latitude from a pole to the equator of spheres and capsule caps */
+	constexpr int32 HemisphereRings = 8;
+
+	/** Keeps the cache bounded for needle-like capsules; the instance scale makes up the rest */
+	constexpr int32 MaxCapsuleAspectSteps = 4000;
+
+	const FName GeomMaterialSlot(TEXT("Geom"));
+
+	/**
+	 * Triangle soup with one normal and UV per vertex. Triangles are wound like the model's meshes
+	 * after conversion: (B - A) x (C - A) points out of the surface.
+	 */
+	struct FPrimitiveGeometry
+	{
+		TArray<FVector3f> Positions;
+		TArray<FVector3f> Normals;
+		TArray<FVector2f> UVs;
+		TArray<int32> Indices;
+
+		int32 AddVertex(const FVector3f& Position, const FVector3f& Normal, const FVector2f& UV)
+		{
+			Normals.Add(Normal);
+			UVs.Add(UV);
+			return Positions.Add(Position);
+		}
+
+		void AddTriangle(const int32 A, const int32 B, const int32 C)
+		{
+			Indices.Append({A, B, C});
+		}
+	};
+
+	/** Half-extent 1; every face has its own vertices so the edges stay sharp */
+	void BuildBox(FPrimitiveGeometry& Out)
+	{
+		// Face normal and two tangents with U x V = N, so the corners below run counter-clockwise about N
+		const FVector3f Faces[6][3] = {
+			{FVector3f::XAxisVector, FVector3f::YAxisVector, FVector3f::ZAxisVector},
+			{-FVector3f::XAxisVector, FVector3f::ZAxisVector, FVector3f::YAxisVector},
+			{FVector3f::YAxisVector, FVector3f::ZAxisVector, FVector3f::XAxisVector},
+			{-FVector3f::YAxisVector, FVector3f::XAxisVector, FVector3f::ZAxisVector},
+			{FVector3f::ZAxisVector, FVector3f::XAxisVector, FVector3f::YAxisVector},
+			{-FVector3f::ZAxisVector, FVector3f::YAxisVector, FVector3f::XAxisVector},
+		};
+
+		for (const FVector3f (&Face)[3] : Faces)
+		{
+			const FVector3f& N = Face[0];
+			const FVector3f& U = Face[1];
+			const FVector3f& V = Face[2];
+			const int32 First = Out.AddVertex(N - U - V, N, FVector2f(0.0f, 0.0f));
+			Out.AddVertex(N + U - V, N, FVector2f(1.0f, 0.0f));
+			Out.AddVertex(N + U + V, N, FVector2f(1.0f, 1.0f));
+			Out.AddVertex(N - U + V, N, FVector2f(0.0f, 1.0f));
+			Out.AddTriangle(First, First + 1, First + 2);
+			Out.AddTriangle(First, First + 2, First + 3);
+		}
+	}
+
+	/** Half-extent 1 in X and Y, facing +Z like MuJoCo's planes */
+	void BuildPlane(FPrimitiveGeometry& Out)
+	{
+		const FVector3f N = FVector3f::ZAxisVector;
+		Out.AddVertex(FVector3f(-1.0f, -1.0f, 0.0f), N, FVector2f(0.0f, 0.0f));
+		Out.AddVertex(FVector3f(1.0f, -1.0f, 0.0f), N, FVector2f(1.0f, 0.0f));
+		Out.AddVertex(FVector3f(1.0f, 1.0f, 0.0f), N, FVector2f(1.0f, 1.0f));
+		Out.AddVertex(FVector3f(-1.0f, 1.0f, 0.0f), N, FVector2f(0.0f, 1.0f));
+		Out.AddTriangle(0, 1, 2);
+		Out.AddTriangle(0, 2, 3);
+	}
+
+	/**
+	 * Sphere of radius 1, or with HalfLength > 0 a capsule of radius 1 along Z: the hemispheres
+	 * move HalfLength up and down and a band of the equator's normals joins them.
+	 */
+	void BuildRoundShape(FPrimitiveGeometry& Out, const double HalfLength)
+	{
+		// Rows of latitude from the north pole down; a capsule repeats the equator, once per cap
+		const float Offset = static_cast<float>(HalfLength);
+		TArray<TPair<float, float>, TInlineAllocator<2 * HemisphereRings + 2>> Rows;
+		for (int32 Ring = 0; Ring <= HemisphereRings; ++Ring)
+		{
+			Rows.Emplace(UE_HALF_PI * Ring / HemisphereRings, Offset);
+		}
+		for (int32 Ring = Offset > 0.0f ? 0 : 1; Ring <= HemisphereRings; ++Ring)
+		{
+			Rows.Emplace(UE_HALF_PI + UE_HALF_PI * Ring / HemisphereRings, -Offset);
+		}
+
+		const float Height = 2.0f * (1.0f + Offset);
+		for (const TPair<float, float>& Row : Rows)
+		{
+			float SinTheta, CosTheta;
+			FMath::SinCos(&SinTheta, &CosTheta, Row.Key);
+			const float Z = CosTheta + Row.Value;
+
+			// The seam is duplicated so the texture wraps once
+			for (int32 Segment = 0; Segment <= CircleSegments; ++Segment)
+			{
+				float SinPhi, CosPhi;
+				FMath::SinCos(&SinPhi, &CosPhi, UE_TWO_PI * Segment / CircleSegments);
+				const FVector3f Normal(SinTheta * CosPhi, SinTheta * SinPhi, CosTheta);
+				Out.AddVertex(
+					FVector3f(Normal.X, Normal.Y, Z),
+					Normal,
+					FVector2f(static_cast<float>(Segment) / CircleSegments, (1.0f + Offset - Z) / Height));
+			}
+		}
+
+		// Latitude grows downwards and longitude counter-clockwise about Z; pole triangles are degenerate
+		const int32 Stride = CircleSegments + 1;
+		for (int32 Row = 0; Row + 1 < Rows.Num(); ++Row)
+		{
+			for (int32 Segment = 0; Segment < CircleSegments; ++Segment)
+			{
+				const int32 A = Row * Stride + Segment;
+				const int32 B = A + Stride;
+				const int32 C = B + 1;
+				const int32 D = A + 1;
+				if (Row > 0)
+				{
+					Out.AddTriangle(A, B, D);
+				}
+				if (Row + 2 < Rows.Num())
+				{
+					Out.AddTriangle(D, B, C);
+				}
+			}
+		}
+	}
+
+	/** Radius 1 and half-height 1 along Z, capped, with hard edges at the rims */
+	void BuildCylinder(FPrimitiveGeometry& Out)
+	{
+		const int32 Stride = CircleSegments + 1;
+		for (const float Z : {1.0f, -1.0f})
+		{
+			for (int32 Segment = 0; Segment <= CircleSegments; ++Segment)
+			{
+				float SinPhi, CosPhi;
+				FMath::SinCos(&SinPhi, &CosPhi, UE_TWO_PI * Segment / CircleSegments);
+				Out.AddVertex(FVector3f(CosPhi, SinPhi, Z), FVector3f(CosPhi, SinPhi, 0.0f), FVector2f(static_cast<float>(Segment) / CircleSegments, (1.0f - Z) * 0.5f));
+			}
+		}
+		for (int32 Segment = 0; Segment < CircleSegments; ++Segment)
+		{
+			const int32 A = Segment;
+			const int32 B = A + Stride;
+			Out.AddTriangle(A, B, A + 1);
+			Out.AddTriangle(A + 1, B, B + 1);
+		}
+
+		for (const float Z : {1.0f, -1.0f})
+		{
+			const FVector3f Normal(0.0f, 0.0f, Z);
+			const int32 Center = Out.AddVertex(FVector3f(0.0f, 0.0f, Z), Normal, FVector2f(0.5f, 0.5f));
+			for (int32 Segment = 0; Segment <= CircleSegments; ++Segment)
+			{
+				float SinPhi, CosPhi;
+				FMath::SinCos(&SinPhi, &CosPhi, UE_TWO_PI * Segment / CircleSegments);
+				Out.AddVertex(FVector3f(CosPhi, SinPhi, Z), Normal, FVector2f(0.5f + 0.5f * CosPhi, 0.5f + 0.5f * SinPhi));
+			}
+
+			// Counter-clockwise seen from above for the top cap, clockwise for the bottom one
+			for (int32 Segment = 0; Segment < CircleSegments; ++Segment)
+			{
+				const int32 A = Center + 1 + Segment;
+				if (Z > 0.0f)
+				{
+					Out.AddTriangle(Center, A, A + 1);
+				}
+				else
+				{
+					Out.AddTriangle(Center, A + 1, A);
+				}
+			}
+		}
+	}
+
+	/** Any unit vector perpendicular to Normal, for the tangent basis */
+	FVector3f MakeTangent(const FVector3f& Normal)
+	{
+		const FVector3f Reference = FMath::Abs(Normal.Z) < 0.999f ? FVector3f::ZAxisVector : FVector3f::XAxisVector;
+		return FVector3f::CrossProduct(Reference, Normal).GetSafeNormal();
+	}
+
+	UStaticMesh* CreateStaticMesh(const FPrimitiveGeometry& Geometry, UObject* Outer, const FName Name)
+	{
+		FMeshDescription Description;
+		FStaticMeshAttributes Attributes(Description);
+		Attributes.Register();
+
+		const int32 NumVertices = Geometry.Positions.Num();
+		const int32 NumTriangles = Geometry.Indices.Num() / 3;
+		Description.ReserveNewVertices(NumVertices);
+		Description.ReserveNewVertexInstances(NumVertices);
+		Description.ReserveNewTriangles(NumTriangles);
+		Description.ReserveNewPolygons(NumTriangles);
+
+		const FPolygonGroupID Group = Description.CreatePolygonGroup();
+		Attributes.GetPolygonGroupMaterialSlotNames()[Group] = GeomMaterialSlot;
+
+		const TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+		const TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+		const TVertexInstanceAttributesRef<FVector3f> Tangents = Attributes.GetVertexInstanceTangents();
+		const TVertexInstanceAttributesRef<float> BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+		const TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+
+		TArray<FVertexInstanceID> Instances;
+		Instances.Reserve(NumVertices);
+		for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+		{
+			const FVertexID VertexID = Description.CreateVertex();
+			Positions[VertexID] = Geometry.Positions[Vertex];
+
+			const FVertexInstanceID Instance = Description.CreateVertexInstance(VertexID);
+			Normals[Instance] = Geometry.Normals[Vertex];
+			Tangents[Instance] = MakeTangent(Geometry.Normals[Vertex]);
+			BinormalSigns[Instance] = 1.0f;
+			UVs[Instance] = Geometry.UVs[Vertex];
+			Instances.Add(Instance);
+		}
+
+		for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+		{
+			const FVertexInstanceID Corners[3] = {
+				Instances[Geometry.Indices[Triangle * 3]],
+				Instances[Geometry.Indices[Triangle * 3 + 1]],
+				Instances[Geometry.Indices[Triangle * 3 + 2]],
+			};
+			Description.CreateTriangle(Group, Corners);
+		}
+
+		UStaticMesh* Mesh = NewObject<UStaticMesh>(Outer, MakeUniqueObjectName(Outer, UStaticMesh::StaticClass(), Name), RF_Transient);
+		Mesh->GetStaticMaterials().Add(FStaticMaterial(UMaterial::GetDefaultMaterial(MD_Surface), GeomMaterialSlot));
+
+		// Built straight to render data; instances are posed every frame and never collide
+		UStaticMesh::FBuildMeshDescriptionsParams Params;
+		Params.bFastBuild = true;
+		Params.bBuildSimpleCollision = false;
+		Params.bAllowCpuAccess = false;
+		Mesh->BuildFromMeshDescriptions({&Description}, Params);
+		return Mesh;
+	}
+}
+
+
+UStaticMesh* UMujocoPrimitiveMeshSubsystem::FindOrCreate(const mjtGeom Type, const FVector& HalfSize, FVector& OutScale)
+{
+	int32 AspectSteps = 0;
+	switch (Type)
+	{
+	case mjGEOM_PLANE:
+		OutScale = FVector(
+			HalfSize.X > 0.0 ? HalfSize.X : InfinitePlaneHalfExtent,
+			HalfSize.Y > 0.0 ? HalfSize.Y : InfinitePlaneHalfExtent,
+			1.0);
+		break;
+	case mjGEOM_SPHERE:
+		OutScale = FVector(HalfSize.X);
+		break;
+	case mjGEOM_ELLIPSOID:
+		OutScale = HalfSize;
+		break;
+	case mjGEOM_CYLINDER:
+		OutScale = FVector(HalfSize.X, HalfSize.X, HalfSize.Y);
+		break;
+	case mjGEOM_BOX:
+		OutScale = HalfSize;
+		break;
+	case mjGEOM_CAPSULE:
+		{
+			// Radius and half-length come from the mesh; the Z scale absorbs the rounding of the ratio
+			const double Radius = FMath::Max(HalfSize.X, UE_KINDA_SMALL_NUMBER);
+			AspectSteps = FMath::Clamp(FMath::RoundToInt32(HalfSize.Y / Radius / CapsuleAspectStep), 0, MaxCapsuleAspectSteps);
+			OutScale = FVector(Radius, Radius, (HalfSize.Y + Radius) / (AspectSteps * CapsuleAspectStep + 1.0));
+		}
+		break;
+	default:
+		return nullptr;
+	}
+
+	// Ellipsoids are scaled spheres
+	const mjtGeom Shape = Type == mjGEOM_ELLIPSOID ? mjGEOM_SPHERE : Type;
+	const uint32 Key = static_cast<uint32>(Shape) | static_cast<uint32>(AspectSteps) << 8;
+	if (const TObjectPtr<UStaticMesh>* Found = Meshes.Find(Key))
+	{
+		return *Found;
+	}
+
+	FPrimitiveGeometry Geometry;
+	FName Name;
+	switch (Shape)
+	{
+	case mjGEOM_PLANE:
+		BuildPlane(Geometry);
+		Name = TEXT("MujocoPlane");
+		break;
+	case mjGEOM_SPHERE:
+		BuildRoundShape(Geometry, 0.0);
+		Name = TEXT("MujocoSphere");
+		break;
+	case mjGEOM_CYLINDER:
+		BuildCylinder(Geometry);
+		Name = TEXT("MujocoCylinder");
+		break;
+	case mjGEOM_CAPSULE:
+		BuildRoundShape(Geometry, AspectSteps * CapsuleAspectStep);
+		Name = TEXT("MujocoCapsule");
+		break;
+	default:
+		BuildBox(Geometry);
+		Name = TEXT("MujocoBox");
+		break;
+	}
+
+	UStaticMesh* Mesh = CreateStaticMesh(Geometry, this, Name);
+	Meshes.Add(Key, Mesh);
+	UE_LOG(LogMujocoMeshes, Verbose, TEXT("Generated %s (%d vertices, %d triangles)."), *Mesh->GetName(), Geometry.Positions.Num(), Geometry.Indices.Num() / 3);
+	return Mesh;
+}
+
+UStaticMesh* UMujocoPrimitiveMeshSubsystem::CreateHeightfield(const mjModel* Model, const int32 Hfield, const FMujocoConversion& Conversion, UObject* Outer)
+{
+	if (!Model || Hfield < 0 || Hfield >= Model->nhfield)
+	{
+		return nullptr;
+	}
+
+	const int32 NumRows = Model->hfield_nrow[Hfield];
+	const int32 NumColumns = Model->hfield_ncol[Hfield];
+	if (NumRows < 2 || NumColumns < 2)
+	{
+		UE_LOG(LogMujocoMeshes, Warning, TEXT("Heightfield %d has %d x %d samples; nothing to draw."), Hfield, NumRows, NumColumns);
+		return nullptr;
+	}
+
+	// Elevations are normalized to [0, 1]; rows run along +Y and columns along +X, both spanning [-size, size]
+	const mjtNum* Size = Model->hfield_size + Hfield * 4;
+	const float* Elevation = Model->hfield_data + Model->hfield_adr[Hfield];
+	const double CellX = 2.0 * Size[0] / (NumColumns - 1);
+	const double CellY = 2.0 * Size[1] / (NumRows - 1);
+	auto Height = [&](const int32 Row, const int32 Column)
+	{
+		return Elevation[FMath::Clamp(Row, 0, NumRows - 1) * NumColumns + FMath::Clamp(Column, 0, NumColumns - 1)] * Size[2];
+	};
+
+	FPrimitiveGeometry Geometry;
+	Geometry.Positions.Reserve(NumRows * NumColumns);
+	Geometry.Normals.Reserve(NumRows * NumColumns);
+	Geometry.UVs.Reserve(NumRows * NumColumns);
+	Conversion.Dispatch([&](auto Axes)
+	{
+		using FAxes = decltype(Axes);
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			for (int32 Column = 0; Column < NumColumns; ++Column)
+			{
+				const float Position[3] = {
+					static_cast<float>(Column * CellX - Size[0]),
+					static_cast<float>(Row * CellY - Size[1]),
+					static_cast<float>(Height(Row, Column)),
+				};
+
+				// Central differences, one-sided at the border
+				const int32 Left = FMath::Max(Column - 1, 0);
+				const int32 Right = FMath::Min(Column + 1, NumColumns - 1);
+				const int32 Down = FMath::Max(Row - 1, 0);
+				const int32 Up = FMath::Min(Row + 1, NumRows - 1);
+				const FVector3f Slope = FVector3f(
+					static_cast<float>(-(Height(Row, Right) - Height(Row, Left)) / ((Right - Left) * CellX)),
+					static_cast<float>(-(Height(Up, Column) - Height(Down, Column)) / ((Up - Down) * CellY)),
+					1.0f).GetSafeNormal();
+				const float Normal[3] = { Slope.X, Slope.Y, Slope.Z };
+
+				Geometry.AddVertex(
+					FVector3f(MujocoConversion::ToUnrealVertex<FAxes>(Position, Conversion.UnitScale)),
+					FVector3f(MujocoConversion::ToUnrealVertex<FAxes>(Normal, 1.0)),
+					FVector2f(static_cast<float>(Column) / (NumColumns - 1), static_cast<float>(Row) / (NumRows - 1)));
+			}
+		}
+	});
+
+	// Facing +Z in MuJoCo's frame; wound the other way when the conversion mirrors
+	const bool bFlipWinding = Conversion.FlipsWinding();
+	Geometry.Indices.Reserve((NumRows - 1) * (NumColumns - 1) * 6);
+	for (int32 Row = 0; Row + 1 < NumRows; ++Row)
+	{
+		for (int32 Column = 0; Column + 1 < NumColumns; ++Column)
+		{
+			const int32 A = Row * NumColumns + Column;
+			const int32 B = A + 1;
+			const int32 C = B + NumColumns;
+			const int32 D = A + NumColumns;
+			if (bFlipWinding)
+			{
+				Geometry.AddTriangle(A, C, B);
+				Geometry.AddTriangle(A, D, C);
+			}
+			else
+			{
+				Geometry.AddTriangle(A, B, C);
+				Geometry.AddTriangle(A, C, D);
+			}
+		}
+	}
+
+	return CreateStaticMesh(Geometry, Outer, TEXT("MujocoHeightfield"));
+}
+
+void UMujocoPrimitiveMeshSubsystem::Deinitialize()
+{
+	Meshes.Empty();
+	Super::Deinitialize();
+}
@@ -0,0 +1,407 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoRayTracer.h"
+
+#include "MujocoAPI.h"
+#include "Async/ParallelFor.h"
+
+
+namespace
+{
+	constexpr int32 MaxTrianglesPerLeaf = 4;
+	constexpr int32 MaxTraversalDepth = 64;
+	constexpr int32 CullBlockSize = 64;
+
+	uint8 GroupBit(const int32 Group)
+	{
+		return Group >= 0 && Group < mjNGROUP ? static_cast<uint8>(1u << Group) : 0;
+	}
+
+	/** Slab test; returns false if the box is missed or only hit beyond MaxDistance */
+	bool IntersectBox(const FVector3f& Min, const FVector3f& Max, const double Origin[3], const double InvDirection[3], const double MaxDistance)
+	{
+		double Near = 0.0;
+		double Far = MaxDistance;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			double T0 = (Min[Axis] - Origin[Axis]) * InvDirection[Axis];
+			double T1 = (Max[Axis] - Origin[Axis]) * InvDirection[Axis];
+			if (T0 > T1)
+			{
+				Swap(T0, T1);
+			}
+			Near = FMath::Max(Near, T0);
+			Far = FMath::Min(Far, T1);
+			if (Near > Far)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Moller-Trumbore, double sided; returns -1 on miss */
+	double IntersectTriangle(const float* A, const float* B, const float* C, const double Origin[3], const double Direction[3])
+	{
+		const double E1[3] = {B[0] - A[0], B[1] - A[1], B[2] - A[2]};
+		const double E2[3] = {C[0] - A[0], C[1] - A[1], C[2] - A[2]};
+		const double P[3] = {
+			Direction[1] * E2[2] - Direction[2] * E2[1],
+			Direction[2] * E2[0] - Direction[0] * E2[2],
+			Direction[0] * E2[1] - Direction[1] * E2[0]
+		};
+
+		const double Det = E1[0] * P[0] + E1[1] * P[1] + E1[2] * P[2];
+		if (FMath::Abs(Det) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			return -1.0;
+		}
+
+		const double InvDet = 1.0 / Det;
+		const double S[3] = {Origin[0] - A[0], Origin[1] - A[1], Origin[2] - A[2]};
+		const double U = (S[0] * P[0] + S[1] * P[1] + S[2] * P[2]) * InvDet;
+		if (U < 0.0 || U > 1.0)
+		{
+			return -1.0;
+		}
+
+		const double Q[3] = {
+			S[1] * E1[2] - S[2] * E1[1],
+			S[2] * E1[0] - S[0] * E1[2],
+			S[0] * E1[1] - S[1] * E1[0]
+		};
+		const double V = (Direction[0] * Q[0] + Direction[1] * Q[1] + Direction[2] * Q[2]) * InvDet;
+		if (V < 0.0 || U + V > 1.0)
+		{
+			return -1.0;
+		}
+
+		const double T = (E2[0] * Q[0] + E2[1] * Q[1] + E2[2] * Q[2]) * InvDet;
+		return T > 0.0 ? T : -1.0;
+	}
+}
+
+
+void FMujocoMeshBVH::Build(const mjModel* Model, const int32 MeshId)
+{
+	Vertices = Model->mesh_vert + Model->mesh_vertadr[MeshId] * 3;
+	const int* Faces = Model->mesh_face + Model->mesh_faceadr[MeshId] * 3;
+	const int32 NumFaces = Model->mesh_facenum[MeshId];
+
+	TArray<FBuildTriangle> BuildTriangles;
+	BuildTriangles.SetNumUninitialized(NumFaces);
+	for (int32 i = 0; i < NumFaces; ++i)
+	{
+		FBuildTriangle& Triangle = BuildTriangles[i];
+		Triangle.Indices = FIntVector3(Faces[i * 3], Faces[i * 3 + 1], Faces[i * 3 + 2]);
+		Triangle.Centroid = FVector3f::ZeroVector;
+		for (int32 Corner = 0; Corner < 3; ++Corner)
+		{
+			const float* Vertex = Vertices + Triangle.Indices[Corner] * 3;
+			Triangle.Centroid += FVector3f(Vertex[0], Vertex[1], Vertex[2]) / 3.0f;
+		}
+	}
+
+	Nodes.Reset();
+	Nodes.Reserve(FMath::Max(1, 2 * NumFaces / MaxTrianglesPerLeaf));
+	if (NumFaces > 0)
+	{
+		BuildRecursive(BuildTriangles, 0, NumFaces);
+	}
+
+	Triangles.SetNumUninitialized(NumFaces);
+	for (int32 i = 0; i < NumFaces; ++i)
+	{
+		Triangles[i] = BuildTriangles[i].Indices;
+	}
+}
+
+int32 FMujocoMeshBVH::BuildRecursive(TArray<FBuildTriangle>& BuildTriangles, const int32 First, const int32 Count)
+{
+	const int32 NodeIndex = Nodes.AddUninitialized();
+
+	FVector3f Min(UE_BIG_NUMBER);
+	FVector3f Max(-UE_BIG_NUMBER);
+	FVector3f CentroidMin(UE_BIG_NUMBER);
+	FVector3f CentroidMax(-UE_BIG_NUMBER);
+	for (int32 i = First; i < First + Count; ++i)
+	{
+		for (int32 Corner = 0; Corner < 3; ++Corner)
+		{
+			const float* Vertex = Vertices + BuildTriangles[i].Indices[Corner] * 3;
+			const FVector3f Position(Vertex[0], Vertex[1], Vertex[2]);
+			Min = FVector3f::Min(Min, Position);
+			Max = FVector3f::Max(Max, Position);
+		}
+		CentroidMin = FVector3f::Min(CentroidMin, BuildTriangles[i].Centroid);
+		CentroidMax = FVector3f::Max(CentroidMax, BuildTriangles[i].Centroid);
+	}
+
+	if (Count <= MaxTrianglesPerLeaf)
+	{
+		Nodes[NodeIndex] = {Min, First, Max, Count};
+		return NodeIndex;
+	}
+
+	// Median split along the widest centroid axis
+	const FVector3f Extent = CentroidMax - CentroidMin;
+	const int32 Axis = Extent.X > Extent.Y ? (Extent.X > Extent.Z ? 0 : 2) : (Extent.Y > Extent.Z ? 1 : 2);
+	MakeArrayView(BuildTriangles.GetData() + First, Count).Sort([Axis](const FBuildTriangle& A, const FBuildTriangle& B)
+	{
+		return A.Centroid[Axis] < B.Centroid[Axis];
+	});
+
+	// The left child is always the next node, so only the right one is stored
+	const int32 LeftCount = Count / 2;
+	BuildRecursive(BuildTriangles, First, LeftCount);
+	const int32 Right = BuildRecursive(BuildTriangles, First + LeftCount, Count - LeftCount);
+
+	Nodes[NodeIndex] = {Min, Right, Max, 0};
+	return NodeIndex;
+}
+
+double FMujocoMeshBVH::Intersect(const double Origin[3], const double Direction[3], const double MaxDistance) const
+{
+	if (Nodes.IsEmpty())
+	{
+		return -1.0;
+	}
+
+	const double InvDirection[3] = {
+		1.0 / (Direction[0] != 0.0 ? Direction[0] : UE_DOUBLE_SMALL_NUMBER),
+		1.0 / (Direction[1] != 0.0 ? Direction[1] : UE_DOUBLE_SMALL_NUMBER),
+		1.0 / (Direction[2] != 0.0 ? Direction[2] : UE_DOUBLE_SMALL_NUMBER)
+	};
+
+	double Best = MaxDistance;
+	bool bHit = false;
+
+	int32 Stack[MaxTraversalDepth];
+	int32 StackSize = 0;
+	Stack[StackSize++] = 0;
+
+	while (StackSize > 0)
+	{
+		const int32 NodeIndex = Stack[--StackSize];
+		const FNode& Node = Nodes[NodeIndex];
+		if (!IntersectBox(Node.Min, Node.Max, Origin, InvDirection, Best))
+		{
+			continue;
+		}
+
+		if (Node.Count > 0)
+		{
+			for (int32 i = Node.FirstOrRight; i < Node.FirstOrRight + Node.Count; ++i)
+			{
+				const FIntVector3& Triangle = Triangles[i];
+				const double T = IntersectTriangle(Vertices + Triangle.X * 3, Vertices + Triangle.Y * 3, Vertices + Triangle.Z * 3, Origin, Direction);
+				if (T >= 0.0 && T < Best)
+				{
+					Best = T;
+					bHit = true;
+				}
+			}
+			continue;
+		}
+
+		// Median splits keep the tree at most 32 levels deep, so the stack cannot overflow
+		Stack[StackSize++] = Node.FirstOrRight;
+		Stack[StackSize++] = NodeIndex + 1;
+	}
+
+	return bHit ? Best : -1.0;
+}
+
+
+void FMujocoRayTracer::BindToModel(const std::shared_ptr<FMujocoAPI>& InApi, const mjModel* InModel)
+{
+	Unbind();
+	if (!InApi || !InModel)
+	{
+		return;
+	}
+
+	Api = InApi;
+	Model = InModel;
+
+	TArray<int32> UsedMeshes;
+	for (int32 Geom = 0; Geom < Model->ngeom; ++Geom)
+	{
+		if (Model->geom_type[Geom] == mjGEOM_MESH && Model->geom_dataid[Geom] >= 0)
+		{
+			UsedMeshes.AddUnique(Model->geom_dataid[Geom]);
+		}
+	}
+
+	MeshBVHs.SetNum(Model->nmesh);
+	ParallelFor(UsedMeshes.Num(), [this, &UsedMeshes](const int32 Index)
+	{
+		TUniquePtr<FMujocoMeshBVH> BVH = MakeUnique<FMujocoMeshBVH>();
+		BVH->Build(Model, UsedMeshes[Index]);
+		MeshBVHs[UsedMeshes[Index]] = MoveTemp(BVH);
+	});
+}
+
+void FMujocoRayTracer::Unbind()
+{
+	MeshBVHs.Empty();
+	CenterX.Reset();
+	CenterY.Reset();
+	CenterZ.Reset();
+	RadiusSquared.Reset();
+	GroupBits.Reset();
+	BoundedGeoms.Reset();
+	PlaneGeoms.Reset();
+	PlaneGroupBits.Reset();
+	Model = nullptr;
+	Data = nullptr;
+	Api.reset();
+}
+
+void FMujocoRayTracer::Prepare(const mjData* InData)
+{
+	Data = InData;
+	CenterX.Reset();
+	CenterY.Reset();
+	CenterZ.Reset();
+	RadiusSquared.Reset();
+	GroupBits.Reset();
+	BoundedGeoms.Reset();
+	PlaneGeoms.Reset();
+	PlaneGroupBits.Reset();
+
+	if (!Model || !Data)
+	{
+		return;
+	}
+
+	for (int32 Geom = 0; Geom < Model->ngeom; ++Geom)
+	{
+		// Same visibility rule as mj_ray: fully transparent geoms are not seen
+		if (Model->geom_rgba[Geom * 4 + 3] == 0.0f)
+		{
+			continue;
+		}
+
+		const int32 Type = Model->geom_type[Geom];
+		if (Type == mjGEOM_PLANE)
+		{
+			PlaneGeoms.Add(Geom);
+			PlaneGroupBits.Add(GroupBit(Model->geom_group[Geom]));
+			continue;
+		}
+
+		// Height fields and SDFs are not supported by this tracer
+		if (Type == mjGEOM_HFIELD || Type == mjGEOM_SDF || (Type == mjGEOM_MESH && !MeshBVHs[Model->geom_dataid[Geom]]))
+		{
+			continue;
+		}
+
+		const mjtNum* Position = Data->geom_xpos + Geom * 3;
+		CenterX.Add(Position[0]);
+		CenterY.Add(Position[1]);
+		CenterZ.Add(Position[2]);
+		RadiusSquared.Add(FMath::Square(Model->geom_rbound[Geom]));
+		GroupBits.Add(GroupBit(Model->geom_group[Geom]));
+		BoundedGeoms.Add(Geom);
+	}
+}
+
+double FMujocoRayTracer::Trace(const double Origin[3], const double Direction[3], const double MaxDistance, const uint8 GroupMask) const
+{
+	if (!Model || !Data)
+	{
+		return -1.0;
+	}
+
+	double Best = MaxDistance;
+	bool bHit = false;
+
+	for (int32 i = 0; i < PlaneGeoms.Num(); ++i)
+	{
+		if (!(PlaneGroupBits[i] & GroupMask))
+		{
+			continue;
+		}
+
+		const int32 Geom = PlaneGeoms[i];
+		const double T = Api->RayGeom(Data->geom_xpos + Geom * 3, Data->geom_xmat + Geom * 9, Model->geom_size + Geom * 3, Origin, Direction, mjGEOM_PLANE);
+		if (T >= 0.0 && T < Best)
+		{
+			Best = T;
+			bHit = true;
+		}
+	}
+
+	const int32 NumBounded = BoundedGeoms.Num();
+	for (int32 BlockStart = 0; BlockStart < NumBounded; BlockStart += CullBlockSize)
+	{
+		const int32 BlockCount = FMath::Min(CullBlockSize, NumBounded - BlockStart);
+
+		// Branch-free bounding sphere test over a block of geoms; compilers vectorize this loop
+		uint8 Crossed[CullBlockSize];
+		for (int32 j = 0; j < BlockCount; ++j)
+		{
+			const int32 i = BlockStart + j;
+			const double Ox = Origin[0] - CenterX[i];
+			const double Oy = Origin[1] - CenterY[i];
+			const double Oz = Origin[2] - CenterZ[i];
+			const double B = Ox * Direction[0] + Oy * Direction[1] + Oz * Direction[2];
+			const double C = Ox * Ox + Oy * Oy + Oz * Oz - RadiusSquared[i];
+			Crossed[j] = (B * B - C >= 0.0) & ((C <= 0.0) | (B <= 0.0)) & ((GroupBits[i] & GroupMask) != 0);
+		}
+
+		for (int32 j = 0; j < BlockCount; ++j)
+		{
+			if (!Crossed[j])
+			{
+				continue;
+			}
+
+			const int32 i = BlockStart + j;
+			const int32 Geom = BoundedGeoms[i];
+
+			// Skip geoms whose bounding sphere starts beyond the current best hit
+			const double Ox = Origin[0] - CenterX[i];
+			const double Oy = Origin[1] - CenterY[i];
+			const double Oz = Origin[2] - CenterZ[i];
+			const double B = Ox * Direction[0] + Oy * Direction[1] + Oz * Direction[2];
+			const double C = Ox * Ox + Oy * Oy + Oz * Oz - RadiusSquared[i];
+			if (-B - FMath::Sqrt(FMath::Max(B * B - C, 0.0)) > Best)
+			{
+				continue;
+			}
+
+			const mjtNum* Position = Data->geom_xpos + Geom * 3;
+			const mjtNum* Rotation = Data->geom_xmat + Geom * 9;
+			double T;
+			if (Model->geom_type[Geom] == mjGEOM_MESH)
+			{
+				// Move the ray into the geom frame, where the mesh vertices live
+				const double Delta[3] = {Origin[0] - Position[0], Origin[1] - Position[1], Origin[2] - Position[2]};
+				const double LocalOrigin[3] = {
+					Rotation[0] * Delta[0] + Rotation[3] * Delta[1] + Rotation[6] * Delta[2],
+					Rotation[1] * Delta[0] + Rotation[4] * Delta[1] + Rotation[7] * Delta[2],
+					Rotation[2] * Delta[0] + Rotation[5] * Delta[1] + Rotation[8] * Delta[2]
+				};
+				const double LocalDirection[3] = {
+					Rotation[0] * Direction[0] + Rotation[3] * Direction[1] + Rotation[6] * Direction[2],
+					Rotation[1] * Direction[0] + Rotation[4] * Direction[1] + Rotation[7] * Direction[2],
+					Rotation[2] * Direction[0] + Rotation[5] * Direction[1] + Rotation[8] * Direction[2]
+				};
+				T = MeshBVHs[Model->geom_dataid[Geom]]->Intersect(LocalOrigin, LocalDirection, Best);
+			}
+			else
+			{
+				T = Api->RayGeom(Position, Rotation, Model->geom_size + Geom * 3, Origin, Direction, Model->geom_type[Geom]);
+			}
+
+			if (T >= 0.0 && T < Best)
+			{
+				Best = T;
+				bHit = true;
+			}
+		}
+	}
+
+	return bHit ? Best : -1.0;
+}
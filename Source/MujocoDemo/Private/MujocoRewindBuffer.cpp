@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoRewindBuffer.h"
+
+#include "MujocoAPI.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoRewind);
+
+
+bool FMujocoRewindBuffer::Initialize(const FMujocoAPI& Api, const mjModel* Model, const int64 MemoryBudgetBytes, const int32 InKeyframeInterval)
+{
+	Release();
+
+	if (!Model)
+	{
+		UE_LOG(LogMujocoRewind, Error, TEXT("Cannot initialize rewind buffer without a model."));
+		return false;
+	}
+
+	const int32 Size = Api.GetStateSize(Model, StateSpec);
+	const int64 KeyframeBytes = static_cast<int64>(Size) * sizeof(mjtNum);
+
+	// The budget must at least hold two keyframes, otherwise every capture evicts the previous one
+	if (Size <= 0 || MemoryBudgetBytes < 2 * KeyframeBytes)
+	{
+		UE_LOG(LogMujocoRewind, Error, TEXT("Rewind budget of %lld bytes is too small for a %lld byte state."), MemoryBudgetBytes, KeyframeBytes);
+		return false;
+	}
+
+	StateSize = Size;
+	KeyframeInterval = FMath::Max(1, InKeyframeInterval);
+	Storage.SetNumUninitialized(MemoryBudgetBytes);
+	CurrentKeyframe.SetNumUninitialized(StateSize);
+	StateScratch.SetNumUninitialized(StateSize);
+	EncodeScratch.Reserve(KeyframeBytes);
+	Clear();
+
+	UE_LOG(LogMujocoRewind, Log, TEXT("Rewind buffer: %lld bytes, %lld byte keyframes every %d steps"), MemoryBudgetBytes, KeyframeBytes, KeyframeInterval);
+	return true;
+}
+
+void FMujocoRewindBuffer::Release()
+{
+	Clear();
+	StateSize = 0;
+	Storage.Empty();
+	CurrentKeyframe.Empty();
+	StateScratch.Empty();
+	EncodeScratch.Empty();
+}
+
+void FMujocoRewindBuffer::Clear()
+{
+	Entries.Empty();
+	WriteHead = 0;
+	CurrentKeyframeStep = INDEX_NONE;
+}
+
+int64 FMujocoRewindBuffer::GetUsedBytes() const
+{
+	int64 Used = 0;
+	for (const FEntry& Entry : Entries)
+	{
+		Used += Entry.Size;
+	}
+	return Used;
+}
+
+void FMujocoRewindBuffer::Capture(const FMujocoAPI& Api, const mjModel* Model, const mjData* Data, const int64 Step)
+{
+	if (!IsInitialized() || !Model || !Data)
+	{
+		return;
+	}
+
+	// A gap in the step sequence (reset, reload) invalidates the history
+	if (!Entries.IsEmpty() && Step != Entries.Last().Step + 1)
+	{
+		Clear();
+	}
+
+	Api.GetState(Model, Data, StateScratch.GetData(), StateSpec);
+
+	bool bKeyframe = CurrentKeyframeStep == INDEX_NONE || Step - CurrentKeyframeStep >= KeyframeInterval;
+	Encode(StateScratch.GetData(), bKeyframe);
+
+	// A delta that is no smaller than the state itself is not worth decoding later
+	if (!bKeyframe && EncodeScratch.Num() >= StateSize * static_cast<int64>(sizeof(mjtNum)))
+	{
+		bKeyframe = true;
+		Encode(StateScratch.GetData(), true);
+	}
+
+	int64 Offset = MakeRoom(EncodeScratch.Num());
+
+	// Making room may have evicted the keyframe this delta refers to, and its deltas with it
+	if (!bKeyframe && Entries.IsEmpty())
+	{
+		bKeyframe = true;
+		Encode(StateScratch.GetData(), true);
+		Offset = MakeRoom(EncodeScratch.Num());
+	}
+
+	FMemory::Memcpy(Storage.GetData() + Offset, EncodeScratch.GetData(), EncodeScratch.Num());
+
+	if (bKeyframe)
+	{
+		FMemory::Memcpy(CurrentKeyframe.GetData(), StateScratch.GetData(), StateSize * sizeof(mjtNum));
+		CurrentKeyframeStep = Step;
+	}
+
+	Entries.Add(FEntry{Step, CurrentKeyframeStep, Offset, EncodeScratch.Num()});
+	WriteHead = Offset + EncodeScratch.Num();
+}
+
+bool FMujocoRewindBuffer::Restore(const int64 Step, const FMujocoAPI& Api, const mjModel* Model, mjData* Data)
+{
+	if (Entries.IsEmpty() || Step < GetOldestStep() || Step > GetNewestStep() || !Model || !Data)
+	{
+		UE_LOG(LogMujocoRewind, Warning, TEXT("Step %lld is outside the rewind window [%lld, %lld]."), Step, GetOldestStep(), GetNewestStep());
+		return false;
+	}
+
+	const int32 Index = static_cast<int32>(Step - GetOldestStep());
+	Decode(Index, StateScratch.GetData());
+	Api.SetState(Model, Data, StateScratch.GetData(), StateSpec);
+
+	// Simulation resumes from here, so the future we rewound past no longer exists
+	while (Entries.Last().Step > Step)
+	{
+		Entries.Pop();
+	}
+
+	const FEntry& Newest = Entries.Last();
+	WriteHead = Newest.Offset + Newest.Size;
+	CurrentKeyframeStep = Newest.KeyframeStep;
+	Decode(static_cast<int32>(CurrentKeyframeStep - GetOldestStep()), CurrentKeyframe.GetData());
+	return true;
+}
+
+void FMujocoRewindBuffer::Encode(const mjtNum* State, const bool bKeyframe)
+{
+	EncodeScratch.Reset();
+
+	if (bKeyframe)
+	{
+		EncodeScratch.Append(reinterpret_cast<const uint8*>(State), StateSize * sizeof(mjtNum));
+		return;
+	}
+
+	// Delta layout: [uint32 Count][uint32 Index x Count][uint64 Bits x Count]
+	// Values are compared bitwise so that restoring is exact, including NaNs and signed zeros.
+	const uint64* Bits = reinterpret_cast<const uint64*>(State);
+	const uint64* KeyBits = reinterpret_cast<const uint64*>(CurrentKeyframe.GetData());
+
+	uint32 Count = 0;
+	for (int32 i = 0; i < StateSize; ++i)
+	{
+		Count += Bits[i] != KeyBits[i];
+	}
+
+	EncodeScratch.SetNumUninitialized(sizeof(uint32) + Count * (sizeof(uint32) + sizeof(uint64)));
+	uint8* Out = EncodeScratch.GetData();
+	FMemory::Memcpy(Out, &Count, sizeof(uint32));
+
+	uint8* IndexOut = Out + sizeof(uint32);
+	uint8* ValueOut = IndexOut + Count * sizeof(uint32);
+	for (uint32 i = 0; i < static_cast<uint32>(StateSize); ++i)
+	{
+		if (Bits[i] != KeyBits[i])
+		{
+			FMemory::Memcpy(IndexOut, &i, sizeof(uint32));
+			FMemory::Memcpy(ValueOut, &Bits[i], sizeof(uint64));
+			IndexOut += sizeof(uint32);
+			ValueOut += sizeof(uint64);
+		}
+	}
+}
+
+int64 FMujocoRewindBuffer::MakeRoom(const int64 Size)
+{
+	if (WriteHead + Size > Storage.Num())
+	{
+		// Entries physically past the head are the oldest ones; they are lost when wrapping
+		while (!Entries.IsEmpty() && Entries.First().Offset >= WriteHead)
+		{
+			Entries.PopFront();
+		}
+		WriteHead = 0;
+	}
+
+	while (!Entries.IsEmpty())
+	{
+		const FEntry& Oldest = Entries.First();
+		if (Oldest.Offset >= WriteHead + Size || Oldest.Offset + Oldest.Size <= WriteHead)
+		{
+			break;
+		}
+		Entries.PopFront();
+	}
+
+	EvictOrphans();
+	return WriteHead;
+}
+
+void FMujocoRewindBuffer::EvictOrphans()
+{
+	while (!Entries.IsEmpty() && Entries.First().Step != Entries.First().KeyframeStep)
+	{
+		Entries.PopFront();
+	}
+}
+
+void FMujocoRewindBuffer::Decode(const int32 Index, mjtNum* Out) const
+{
+	const FEntry& Entry = Entries[Index];
+	const FEntry& Keyframe = Entries[Index - static_cast<int32>(Entry.Step - Entry.KeyframeStep)];
+	FMemory::Memcpy(Out, Storage.GetData() + Keyframe.Offset, StateSize * sizeof(mjtNum));
+
+	if (Entry.Step == Entry.KeyframeStep)
+	{
+		return;
+	}
+
+	const uint8* In = Storage.GetData() + Entry.Offset;
+	uint32 Count = 0;
+	FMemory::Memcpy(&Count, In, sizeof(uint32));
+
+	const uint8* IndexIn = In + sizeof(uint32);
+	const uint8* ValueIn = IndexIn + Count * sizeof(uint32);
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		uint32 StateIndex = 0;
+		FMemory::Memcpy(&StateIndex, IndexIn + i * sizeof(uint32), sizeof(uint32));
+		FMemory::Memcpy(Out + StateIndex, ValueIn + i * sizeof(uint64), sizeof(uint64));
+	}
+}
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoRolloutPool.h"
+
+#include "MujocoAPI.h"
+#include "MujocoDataPool.h"
+#include "Async/ParallelFor.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoRollout);
+
+
+FMujocoRolloutPool::~FMujocoRolloutPool()
+{
+	Release();
+}
+
+bool FMujocoRolloutPool::Initialize(const std::shared_ptr<FMujocoDataPool>& InDataPool, const mjModel* InModel, const int32 NumRollouts, const uint32 FinalStateSpec)
+{
+	Release();
+
+	if (!InDataPool || !InModel || NumRollouts <= 0)
+	{
+		UE_LOG(LogMujocoRollout, Error, TEXT("Cannot initialize rollouts without a model."));
+		return false;
+	}
+
+	DataPool = InDataPool;
+	Model = InModel;
+	StateSpec = FinalStateSpec;
+	StateSize = DataPool->GetApi()->GetStateSize(Model, StateSpec);
+
+	// Every Run() overwrites the buffers with mj_copyData, so they don't need a reset
+	Buffers.Reserve(NumRollouts);
+	for (int32 i = 0; i < NumRollouts; ++i)
+	{
+		mjData* Data = DataPool->Acquire(Model, false);
+		if (!Data)
+		{
+			UE_LOG(LogMujocoRollout, Error, TEXT("Failed to allocate rollout buffer %d of %d."), i, NumRollouts);
+			Release();
+			return false;
+		}
+		Buffers.Add(Data);
+	}
+
+	Costs.SetNumZeroed(NumRollouts);
+	FinalStates.SetNumZeroed(NumRollouts * StateSize);
+
+	UE_LOG(LogMujocoRollout, Log, TEXT("Initialized %d rollout buffers"), NumRollouts);
+	return true;
+}
+
+void FMujocoRolloutPool::Release()
+{
+	if (DataPool)
+	{
+		for (mjData* Data : Buffers)
+		{
+			DataPool->Release(Model, Data);
+		}
+	}
+
+	Buffers.Empty();
+	Costs.Empty();
+	FinalStates.Empty();
+	Model = nullptr;
+	StateSize = 0;
+	DataPool.reset();
+}
+
+bool FMujocoRolloutPool::Run(const mjData* Source, const TArrayView<const double> Controls, const int32 Horizon, FMujocoRolloutCost Cost)
+{
+	if (!Model || !Source || Horizon <= 0)
+	{
+		return false;
+	}
+
+	const int32 NumRollouts = Buffers.Num();
+	const int32 Nu = Model->nu;
+	if (Controls.Num() != NumRollouts * Horizon * Nu)
+	{
+		UE_LOG(LogMujocoRollout, Error, TEXT("Expected %d rollout controls, got %d."), NumRollouts * Horizon * Nu, Controls.Num());
+		return false;
+	}
+
+	const FMujocoAPI& Api = *DataPool->GetApi();
+	ParallelFor(NumRollouts, [&](const int32 Rollout)
+	{
+		mjData* Data = Buffers[Rollout];
+		Api.CopyData(Model, Source, Data);
+
+		const double* RolloutControls = Controls.GetData() + static_cast<int64>(Rollout) * Horizon * Nu;
+		double TotalCost = 0.0;
+		for (int32 Step = 0; Step < Horizon; ++Step)
+		{
+			FMemory::Memcpy(Data->ctrl, RolloutControls + Step * Nu, Nu * sizeof(mjtNum));
+			Api.Step(Model, Data);
+			TotalCost += Cost(Model, Data, Rollout, Step);
+		}
+
+		Costs[Rollout] = TotalCost;
+		Api.GetState(Model, Data, FinalStates.GetData() + Rollout * StateSize, StateSpec);
+	});
+
+	return true;
+}
+
+TArrayView<const mjtNum> FMujocoRolloutPool::GetFinalState(const int32 Rollout) const
+{
+	if (!Buffers.IsValidIndex(Rollout))
+	{
+		return {};
+	}
+	return TArrayView<const mjtNum>(FinalStates.GetData() + Rollout * StateSize, StateSize);
+}
+
+int32 FMujocoRolloutPool::GetBestRollout() const
+{
+	int32 Best = INDEX_NONE;
+	for (int32 i = 0; i < Costs.Num(); ++i)
+	{
+		if (Best == INDEX_NONE || Costs[i] < Costs[Best])
+		{
+			Best = i;
+		}
+	}
+	return Best;
+}
@@ -0,0 +1,387 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoSceneBuilder.h"
+
+#include "MujocoAPI.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoScene);
+
+
+namespace
+{
+	/** Smallest span covering every id added, and how many were added */
+	struct FIdSpan
+	{
+		int32 First = MAX_int32;
+		int32 End = 0;
+		int32 Count = 0;
+
+		void Add(const int32 Begin, const int32 Num)
+		{
+			if (Num <= 0)
+			{
+				return;
+			}
+			First = FMath::Min(First, Begin);
+			End = FMath::Max(End, Begin + Num);
+			Count += Num;
+		}
+
+		/** Write the span out; false if the ids were not contiguous */
+		bool Store(int32& OutFirst, int32& OutNum) const
+		{
+			OutFirst = Count > 0 ? First : 0;
+			OutNum = Count > 0 ? End - First : 0;
+			return Count == OutNum;
+		}
+	};
+
+	/** Number of qpos entries of a joint */
+	int32 GetQposSize(const int32 JointType)
+	{
+		switch (JointType)
+		{
+		case mjJNT_FREE:
+			return 7;
+		case mjJNT_BALL:
+			return 4;
+		default:
+			return 1;
+		}
+	}
+}
+
+
+FMujocoSceneBuilder::FMujocoSceneBuilder(std::shared_ptr<FMujocoAPI> InApi)
+	: Api(MoveTemp(InApi))
+{
+}
+
+FMujocoSceneBuilder::~FMujocoSceneBuilder()
+{
+	Reset();
+}
+
+void FMujocoSceneBuilder::Reset()
+{
+	Api->FreeSpec(Spec);
+	Spec = nullptr;
+
+	for (mjSpec* Template : Templates)
+	{
+		Api->FreeSpec(Template);
+	}
+	Templates.Reset();
+	Instances.Reset();
+	InstanceRoots.Reset();
+	GeomElements.Reset();
+	PendingBodies.Reset();
+}
+
+bool FMujocoSceneBuilder::BeginScene(const FString& SceneXMLPath)
+{
+	Reset();
+
+	Spec = SceneXMLPath.IsEmpty() ? Api->MakeSpec() : Api->ParseXMLFile(SceneXMLPath);
+	if (!Spec)
+	{
+		UE_LOG(LogMujocoScene, Error, TEXT("Failed to create the scene spec from '%s'."), *SceneXMLPath);
+		return false;
+	}
+	return true;
+}
+
+int32 FMujocoSceneBuilder::AddTemplate(const FString& XMLPath)
+{
+	mjSpec* Template = Api->ParseXMLFile(XMLPath);
+	if (!Template)
+	{
+		return INDEX_NONE;
+	}
+	return Templates.Add(Template);
+}
+
+int32 FMujocoSceneBuilder::AddInstance(const int32 Template, const FVector& Position, const FQuat& Rotation, FString Prefix)
+{
+	if (!Spec || !Templates.IsValidIndex(Template))
+	{
+		UE_LOG(LogMujocoScene, Error, TEXT("Cannot add an instance of template %d; call BeginScene and AddTemplate first."), Template);
+		return INDEX_NONE;
+	}
+
+	if (Prefix.IsEmpty())
+	{
+		Prefix = FString::Printf(TEXT("robot%d_"), Instances.Num());
+	}
+
+	mjsFrame* Frame = Api->AddFrame(Api->FindSpecBody(Spec, "world"), nullptr);
+	if (!Frame)
+	{
+		return INDEX_NONE;
+	}
+	Frame->pos[0] = Position.X;
+	Frame->pos[1] = Position.Y;
+	Frame->pos[2] = Position.Z;
+	Frame->quat[0] = Rotation.W;
+	Frame->quat[1] = Rotation.X;
+	Frame->quat[2] = Rotation.Y;
+	Frame->quat[3] = Rotation.Z;
+
+	// A template may have several top-level bodies (a robot plus its props); each is attached
+	mjsBody* TemplateWorld = Api->FindSpecBody(Templates[Template], "world");
+	TArray<mjsBody*> Roots;
+	for (mjsElement* Child = Api->FirstChild(TemplateWorld, mjOBJ_BODY, false); Child; Child = Api->NextChild(TemplateWorld, Child, false))
+	{
+		mjsBody* Attached = Api->AttachBody(Frame, Api->AsBody(Child), Prefix, FString());
+		if (!Attached)
+		{
+			UE_LOG(LogMujocoScene, Error, TEXT("Failed to attach instance '%s': %s"), *Prefix, *Api->GetSpecError(Spec));
+			return INDEX_NONE;
+		}
+		Roots.Add(Attached);
+	}
+
+	if (Roots.IsEmpty())
+	{
+		UE_LOG(LogMujocoScene, Warning, TEXT("Template %d has no bodies to instantiate."), Template);
+		return INDEX_NONE;
+	}
+
+	FMujocoRobotInstance& Instance = Instances.AddDefaulted_GetRef();
+	Instance.Prefix = MoveTemp(Prefix);
+	InstanceRoots.Add(MoveTemp(Roots));
+	return Instances.Num() - 1;
+}
+
+mjModel* FMujocoSceneBuilder::Compile()
+{
+	if (!Spec)
+	{
+		return nullptr;
+	}
+
+	mjModel* Model = Api->CompileSpec(Spec);
+	if (!Model)
+	{
+		UE_LOG(LogMujocoScene, Error, TEXT("Failed to compile scene: %s"), *Api->GetSpecError(Spec));
+		return nullptr;
+	}
+
+	PendingBodies.Reset();
+	IndexModel(Model);
+	UE_LOG(LogMujocoScene, Log, TEXT("Compiled scene with %d instances (%d bodies, %d geoms)."), Instances.Num(), Model->nbody, Model->ngeom);
+	return Model;
+}
+
+mjsBody* FMujocoSceneBuilder::AddPrimitiveBody(const FString& Name, const mjtGeom Type, const FVector& Size, const FVector& Position, const FQuat& Rotation, const double Mass, const bool bFreeJoint)
+{
+	if (!Spec)
+	{
+		return nullptr;
+	}
+
+	// A duplicate name would only fail at recompile, after the body is already in the spec
+	const std::string NameStr = TCHAR_TO_UTF8(*Name);
+	if (!Name.IsEmpty() && Api->FindSpecBody(Spec, NameStr.c_str()))
+	{
+		UE_LOG(LogMujocoScene, Warning, TEXT("Cannot add body '%s': the name is taken."), *Name);
+		return nullptr;
+	}
+
+	mjsBody* Body = Api->AddBody(Api->FindSpecBody(Spec, "world"));
+	if (!Body)
+	{
+		return nullptr;
+	}
+
+	mjsGeom* Geom = Api->AddGeom(Body);
+	if (!Geom || (bFreeJoint && !Api->AddFreeJoint(Body)))
+	{
+		Api->DetachBody(Spec, Body);
+		return nullptr;
+	}
+
+	Api->SetSpecString(Body->name, Name);
+	Body->pos[0] = Position.X;
+	Body->pos[1] = Position.Y;
+	Body->pos[2] = Position.Z;
+	Body->quat[0] = Rotation.W;
+	Body->quat[1] = Rotation.X;
+	Body->quat[2] = Rotation.Y;
+	Body->quat[3] = Rotation.Z;
+
+	Geom->type = Type;
+	Geom->size[0] = Size.X;
+	Geom->size[1] = Size.Y;
+	Geom->size[2] = Size.Z;
+	if (Mass > 0.0)
+	{
+		Geom->mass = Mass;
+	}
+
+	PendingBodies.Add(Body);
+	return Body;
+}
+
+bool FMujocoSceneBuilder::RemoveBody(const FString& Name)
+{
+	const std::string NameStr = TCHAR_TO_UTF8(*Name);
+	mjsBody* Body = Api->FindSpecBody(Spec, NameStr.c_str());
+	if (!Body)
+	{
+		UE_LOG(LogMujocoScene, Warning, TEXT("Cannot remove body '%s': not found."), *Name);
+		return false;
+	}
+
+	// Forget the subtree's geoms before their elements are freed
+	for (mjsElement* Geom = Api->FirstChild(Body, mjOBJ_GEOM, true); Geom; Geom = Api->NextChild(Body, Geom, true))
+	{
+		const int32 Index = GeomElements.Find(Geom);
+		if (Index != INDEX_NONE)
+		{
+			GeomElements[Index] = nullptr;
+		}
+	}
+
+	// An instance loses its ranges when any of its roots goes
+	for (int32 Index = Instances.Num() - 1; Index >= 0; --Index)
+	{
+		if (InstanceRoots[Index].Contains(Body))
+		{
+			Instances.RemoveAt(Index);
+			InstanceRoots.RemoveAt(Index);
+		}
+	}
+
+	PendingBodies.Remove(Body);
+	return Api->DetachBody(Spec, Body);
+}
+
+bool FMujocoSceneBuilder::Recompile(mjModel* Model, mjData* Data, TArray<int32>& OutGeomRemap)
+{
+	if (!Spec || !Api->RecompileSpec(Spec, Model, Data))
+	{
+		UE_LOG(LogMujocoScene, Error, TEXT("Failed to recompile scene: %s"), *Api->GetSpecError(Spec));
+
+		// The model is unchanged; drop the bodies that broke it so the next edit starts clean
+		for (mjsBody* Body : PendingBodies)
+		{
+			Api->DetachBody(Spec, Body);
+		}
+		PendingBodies.Reset();
+		return false;
+	}
+	PendingBodies.Reset();
+
+	const TArray<mjsElement*> OldGeomElements = MoveTemp(GeomElements);
+	IndexModel(Model);
+
+	TMap<mjsElement*, int32> NewIds;
+	NewIds.Reserve(GeomElements.Num());
+	for (int32 Geom = 0; Geom < GeomElements.Num(); ++Geom)
+	{
+		if (GeomElements[Geom])
+		{
+			NewIds.Add(GeomElements[Geom], Geom);
+		}
+	}
+
+	OutGeomRemap.SetNumUninitialized(OldGeomElements.Num());
+	for (int32 Geom = 0; Geom < OldGeomElements.Num(); ++Geom)
+	{
+		const int32* NewId = OldGeomElements[Geom] ? NewIds.Find(OldGeomElements[Geom]) : nullptr;
+		OutGeomRemap[Geom] = NewId ? *NewId : INDEX_NONE;
+	}
+
+	UE_LOG(LogMujocoScene, Log, TEXT("Recompiled scene (%d bodies, %d geoms)."), Model->nbody, Model->ngeom);
+	return true;
+}
+
+void FMujocoSceneBuilder::IndexModel(const mjModel* Model)
+{
+	TArray<int32, TInlineAllocator<8>> RootBodies;
+	for (int32 Index = 0; Index < Instances.Num(); ++Index)
+	{
+		RootBodies.Reset();
+		for (mjsBody* Root : InstanceRoots[Index])
+		{
+			RootBodies.Add(Api->GetElementId(Root->element));
+		}
+
+		if (!ResolveRanges(Model, RootBodies, Instances[Index]))
+		{
+			UE_LOG(LogMujocoScene, Warning, TEXT("Instance '%s' did not compile to contiguous ids; its ranges also cover other objects."), *Instances[Index].Prefix);
+		}
+	}
+
+	GeomElements.Init(nullptr, Model->ngeom);
+	for (mjsElement* Geom = Api->FirstElement(Spec, mjOBJ_GEOM); Geom; Geom = Api->NextElement(Spec, Geom))
+	{
+		const int32 Id = Api->GetElementId(Geom);
+		if (GeomElements.IsValidIndex(Id))
+		{
+			GeomElements[Id] = Geom;
+		}
+	}
+}
+
+bool FMujocoSceneBuilder::ResolveRanges(const mjModel* Model, const TConstArrayView<int32> RootBodies, FMujocoRobotInstance& Instance)
+{
+	Instance.RootBody = RootBodies.IsEmpty() ? INDEX_NONE : RootBodies[0];
+
+	FIdSpan Bodies, Joints, Qpos, Dofs, Geoms, Actuators;
+	TBitArray<> InInstance(false, Model->nbody);
+	for (int32 Body = 1; Body < Model->nbody; ++Body)
+	{
+		if (!RootBodies.Contains(Model->body_rootid[Body]))
+		{
+			continue;
+		}
+
+		InInstance[Body] = true;
+		Bodies.Add(Body, 1);
+		Joints.Add(Model->body_jntadr[Body], Model->body_jntnum[Body]);
+		Dofs.Add(Model->body_dofadr[Body], Model->body_dofnum[Body]);
+		Geoms.Add(Model->body_geomadr[Body], Model->body_geomnum[Body]);
+		for (int32 Joint = Model->body_jntadr[Body]; Joint < Model->body_jntadr[Body] + Model->body_jntnum[Body]; ++Joint)
+		{
+			Qpos.Add(Model->jnt_qposadr[Joint], GetQposSize(Model->jnt_type[Joint]));
+		}
+	}
+
+	for (int32 Actuator = 0; Actuator < Model->nu; ++Actuator)
+	{
+		const int32 Target = Model->actuator_trnid[Actuator * 2];
+		int32 Body = INDEX_NONE;
+		switch (Model->actuator_trntype[Actuator])
+		{
+		case mjTRN_JOINT:
+		case mjTRN_JOINTINPARENT:
+			Body = Model->jnt_bodyid[Target];
+			break;
+		case mjTRN_SITE:
+		case mjTRN_SLIDERCRANK:
+			Body = Model->site_bodyid[Target];
+			break;
+		case mjTRN_BODY:
+			Body = Target;
+			break;
+		default:
+			// Tendon actuators can span instances; they are left out of every range
+			break;
+		}
+
+		if (Body >= 0 && InInstance[Body])
+		{
+			Actuators.Add(Actuator, 1);
+		}
+	}
+
+	bool bContiguous = Bodies.Store(Instance.FirstBody, Instance.NumBodies);
+	bContiguous &= Joints.Store(Instance.FirstJoint, Instance.NumJoints);
+	bContiguous &= Qpos.Store(Instance.FirstQpos, Instance.NumQpos);
+	bContiguous &= Dofs.Store(Instance.FirstDof, Instance.NumDofs);
+	bContiguous &= Geoms.Store(Instance.FirstGeom, Instance.NumGeoms);
+	bContiguous &= Actuators.Store(Instance.FirstActuator, Instance.NumActuators);
+	return bContiguous;
+}
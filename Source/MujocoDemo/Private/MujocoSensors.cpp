@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoSensors.h"
+
+#include "MujocoNameIndex.h"
+
+
+static_assert(sizeof(mjtNum) == sizeof(double), "Sensor views assume MuJoCo is built with double precision");
+
+
+namespace
+{
+	/** Shared by all tables, so a handle from one manager's model is not taken for another's */
+	int32 NextGeneration = 1;
+}
+
+
+void FMujocoSensorTable::Build(const mjModel* Model, const FMujocoNameIndex& Names)
+{
+	Reset();
+	if (!Model)
+	{
+		return;
+	}
+
+	NameIndex = &Names;
+	Generation = NextGeneration++;
+	NumSensorData = Model->nsensordata;
+	Handles.Reserve(Model->nsensor);
+	for (int32 Id = 0; Id < Model->nsensor; ++Id)
+	{
+		FMujocoSensorHandle& Handle = Handles.AddDefaulted_GetRef();
+		Handle.Id = Id;
+		Handle.Address = Model->sensor_adr[Id];
+		Handle.Dimension = Model->sensor_dim[Id];
+		Handle.Generation = Generation;
+	}
+}
+
+void FMujocoSensorTable::Reset()
+{
+	Handles.Reset();
+	NameIndex = nullptr;
+	Generation = 0;
+	NumSensorData = 0;
+}
+
+FMujocoSensorHandle FMujocoSensorTable::Find(const FName Name) const
+{
+	const int32 Id = NameIndex ? NameIndex->FindId(mjOBJ_SENSOR, Name) : INDEX_NONE;
+	return Id != INDEX_NONE ? Handles[Id] : FMujocoSensorHandle();
+}
+
+FMujocoSensorBatch FMujocoSensorTable::Resolve(const TConstArrayView<FName> Names, TArray<FName>* OutMissing) const
+{
+	FMujocoSensorBatch Batch;
+	Batch.Generation = Generation;
+	Batch.Sensors.Reserve(Names.Num());
+	for (const FName Name : Names)
+	{
+		const FMujocoSensorHandle Handle = Find(Name);
+		if (Handle.IsValid())
+		{
+			Batch.Sensors.Add(Handle);
+			Batch.NumValues += Handle.Dimension;
+		}
+		else if (OutMissing)
+		{
+			OutMissing->Add(Name);
+		}
+	}
+	return Batch;
+}
+
+bool FMujocoSensorTable::Copy(const mjData* Data, const FMujocoSensorBatch& Batch, TArray<double>& Out) const
+{
+	if (!Data || Batch.Generation != Generation || Generation == 0)
+	{
+		return false;
+	}
+
+	int32 Offset = Out.Num();
+	Out.AddUninitialized(Batch.NumValues);
+	for (const FMujocoSensorHandle& Sensor : Batch.Sensors)
+	{
+		FMemory::Memcpy(Out.GetData() + Offset, Data->sensordata + Sensor.Address, Sensor.Dimension * sizeof(double));
+		Offset += Sensor.Dimension;
+	}
+	return true;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoSimulationLOD.h"
+
+
+EMujocoSimulationLOD FMujocoSimulationLOD::Update(const FMujocoLODSettings& Settings, const double Distance)
+{
+	// Thresholds move away from the current level, so moving back needs a margin
+	const double Closer = 1.0 - Settings.Hysteresis;
+	const double Farther = 1.0 + Settings.Hysteresis;
+	switch (Level)
+	{
+	case EMujocoSimulationLOD::Near:
+		Level = Distance > Settings.FarDistance * Farther ? EMujocoSimulationLOD::Far
+			: Distance > Settings.MidDistance * Farther ? EMujocoSimulationLOD::Mid
+			: EMujocoSimulationLOD::Near;
+		break;
+	case EMujocoSimulationLOD::Mid:
+		Level = Distance > Settings.FarDistance * Farther ? EMujocoSimulationLOD::Far
+			: Distance < Settings.MidDistance * Closer ? EMujocoSimulationLOD::Near
+			: EMujocoSimulationLOD::Mid;
+		break;
+	case EMujocoSimulationLOD::Far:
+		Level = Distance < Settings.MidDistance * Closer ? EMujocoSimulationLOD::Near
+			: Distance < Settings.FarDistance * Closer ? EMujocoSimulationLOD::Mid
+			: EMujocoSimulationLOD::Far;
+		break;
+	}
+	return Level;
+}
+
+double FMujocoSimulationLOD::GetStepRate(const FMujocoLODSettings& Settings) const
+{
+	if (IsFrozen())
+	{
+		return 0.0;
+	}
+
+	switch (Level)
+	{
+	case EMujocoSimulationLOD::Mid:
+		return FMath::Clamp(Settings.MidStepRate, 0.0, 1.0);
+	case EMujocoSimulationLOD::Far:
+		return FMath::Clamp(Settings.FarStepRate, 0.0, 1.0);
+	default:
+		return 1.0;
+	}
+}
+
+void FMujocoSimulationLOD::Release()
+{
+	bFrozen = false;
+	Level = EMujocoSimulationLOD::Near;
+}
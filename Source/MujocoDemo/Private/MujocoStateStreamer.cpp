@@ -0,0 +1,289 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoStateStreamer.h"
+
+#include "HAL/Event.h"
+#include "HAL/RunnableThread.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoStateStreamer);
+
+
+namespace
+{
+	/** How long the server thread sleeps when nothing was published */
+	constexpr uint32 IdleWaitMilliseconds = 5;
+}
+
+
+FMujocoStateStreamer::~FMujocoStateStreamer()
+{
+	Shutdown();
+}
+
+bool FMujocoStateStreamer::Start(const int32 Port, const bool bAllowRemote, const double DefaultMaxRateHz, const int32 QueueDepth)
+{
+	Shutdown();
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!SocketSubsystem)
+	{
+		UE_LOG(LogMujocoStateStreamer, Error, TEXT("No socket subsystem available."));
+		return false;
+	}
+
+	const TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+	if (bAllowRemote)
+	{
+		Address->SetAnyAddress();
+	}
+	else
+	{
+		Address->SetLoopbackAddress();
+	}
+	Address->SetPort(Port);
+
+	ListenSocket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("MuJoCo state stream"), Address->GetProtocolType());
+	if (!ListenSocket || !ListenSocket->SetReuseAddr() || !ListenSocket->SetNonBlocking(true) || !ListenSocket->Bind(*Address) || !ListenSocket->Listen(8))
+	{
+		UE_LOG(LogMujocoStateStreamer, Error, TEXT("Failed to listen on port %d."), Port);
+		if (ListenSocket)
+		{
+			SocketSubsystem->DestroySocket(ListenSocket);
+			ListenSocket = nullptr;
+		}
+		return false;
+	}
+
+	DefaultMinInterval = DefaultMaxRateHz > 0.0 ? 1.0 / DefaultMaxRateHz : 0.0;
+	MaxQueuedFrames = FMath::Max(QueueDepth, 1);
+	DroppedFrames = 0;
+	bStopping = false;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("MujocoStateStreamer"), 0, TPri_BelowNormal);
+
+	UE_LOG(LogMujocoStateStreamer, Log, TEXT("Streaming state on port %d"), Port);
+	return Thread != nullptr;
+}
+
+void FMujocoStateStreamer::Shutdown()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (WakeEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+
+	for (const TUniquePtr<FClient>& Client : Clients)
+	{
+		CloseClient(*Client);
+	}
+	Clients.Empty();
+	NumClients = 0;
+
+	if (ListenSocket)
+	{
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+	}
+}
+
+void FMujocoStateStreamer::Stop()
+{
+	bStopping = true;
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FMujocoStateStreamer::Publish(const mjModel* Model, const mjData* Data, const int64 Step, const FMujocoSensorBatch& Sensors)
+{
+	if (!Model || !Data || NumClients.load(std::memory_order_relaxed) == 0)
+	{
+		return;
+	}
+
+	// Find out who is due a frame before paying for serialization
+	const double Now = FPlatformTime::Seconds();
+	TArray<FClient*, TInlineAllocator<8>> Due;
+	{
+		FScopeLock ScopeLock(&ClientsLock);
+		for (const TUniquePtr<FClient>& Client : Clients)
+		{
+			if (Now >= Client->NextFrameTime)
+			{
+				Client->NextFrameTime = Now + Client->MinInterval;
+				Due.Add(Client.Get());
+			}
+		}
+	}
+
+	if (Due.IsEmpty())
+	{
+		return;
+	}
+
+	const int32 Size = sizeof(FMujocoStreamFrameHeader) + (Model->nq + Sensors.NumValues) * sizeof(double);
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(Size);
+
+	FMujocoStreamFrameHeader Header;
+	Header.Magic = FMujocoStreamFrameHeader::ExpectedMagic;
+	Header.Size = Size;
+	Header.Time = Data->time;
+	Header.Step = Step;
+	Header.NumPositions = Model->nq;
+	Header.NumSensorValues = Sensors.NumValues;
+	Header.NumContacts = Data->ncon;
+
+	uint8* Cursor = Bytes.GetData();
+	FMemory::Memcpy(Cursor, &Header, sizeof(Header));
+	Cursor += sizeof(Header);
+	FMemory::Memcpy(Cursor, Data->qpos, Model->nq * sizeof(double));
+	Cursor += Model->nq * sizeof(double);
+	for (const FMujocoSensorHandle& Sensor : Sensors.Sensors)
+	{
+		FMemory::Memcpy(Cursor, Data->sensordata + Sensor.Address, Sensor.Dimension * sizeof(double));
+		Cursor += Sensor.Dimension * sizeof(double);
+	}
+
+	const FFrame Frame = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Bytes));
+	{
+		FScopeLock ScopeLock(&ClientsLock);
+		for (FClient* Client : Due)
+		{
+			// The client may have disconnected while the frame was built
+			if (!Clients.ContainsByPredicate([Client](const TUniquePtr<FClient>& Other) { return Other.Get() == Client; }))
+			{
+				continue;
+			}
+
+			if (Client->Queue.Num() >= MaxQueuedFrames)
+			{
+				Client->Queue.PopFront();
+				DroppedFrames.fetch_add(1, std::memory_order_relaxed);
+			}
+			Client->Queue.Add(Frame);
+		}
+	}
+
+	WakeEvent->Trigger();
+}
+
+uint32 FMujocoStateStreamer::Run()
+{
+	while (!bStopping)
+	{
+		AcceptClients();
+
+		for (int32 Index = Clients.Num() - 1; Index >= 0; --Index)
+		{
+			if (!ServiceClient(*Clients[Index]))
+			{
+				CloseClient(*Clients[Index]);
+
+				FScopeLock ScopeLock(&ClientsLock);
+				Clients.RemoveAt(Index);
+				NumClients = Clients.Num();
+				UE_LOG(LogMujocoStateStreamer, Log, TEXT("Client disconnected (%d connected)"), NumClients.load());
+			}
+		}
+
+		WakeEvent->Wait(IdleWaitMilliseconds);
+	}
+	return 0;
+}
+
+void FMujocoStateStreamer::AcceptClients()
+{
+	bool bPending = false;
+	while (ListenSocket->HasPendingConnection(bPending) && bPending)
+	{
+		FSocket* Socket = ListenSocket->Accept(TEXT("MuJoCo state stream client"));
+		if (!Socket)
+		{
+			break;
+		}
+
+		Socket->SetNonBlocking(true);
+		Socket->SetNoDelay(true);
+
+		TUniquePtr<FClient> Client = MakeUnique<FClient>();
+		Client->Socket = Socket;
+		Client->MinInterval = DefaultMinInterval;
+
+		FScopeLock ScopeLock(&ClientsLock);
+		Clients.Add(MoveTemp(Client));
+		NumClients = Clients.Num();
+		UE_LOG(LogMujocoStateStreamer, Log, TEXT("Client connected (%d connected)"), NumClients.load());
+	}
+}
+
+bool FMujocoStateStreamer::ServiceClient(FClient& Client)
+{
+	if (Client.Socket->GetConnectionState() == SCS_ConnectionError)
+	{
+		return false;
+	}
+
+	// Rate requests: a uint32 in Hz, 0 for unlimited
+	uint32 PendingBytes = 0;
+	if (Client.Socket->HasPendingData(PendingBytes) && PendingBytes >= sizeof(uint32))
+	{
+		uint32 RateHz = 0;
+		int32 BytesRead = 0;
+		if (Client.Socket->Recv(reinterpret_cast<uint8*>(&RateHz), sizeof(RateHz), BytesRead) && BytesRead == sizeof(RateHz))
+		{
+			FScopeLock ScopeLock(&ClientsLock);
+			Client.MinInterval = RateHz > 0 ? 1.0 / RateHz : 0.0;
+		}
+	}
+
+	for (;;)
+	{
+		if (!Client.Sending.IsValid())
+		{
+			FScopeLock ScopeLock(&ClientsLock);
+			if (Client.Queue.IsEmpty())
+			{
+				return true;
+			}
+			Client.Sending = Client.Queue.PopFrontValue();
+			Client.SendOffset = 0;
+		}
+
+		const TArray<uint8>& Bytes = *Client.Sending;
+		int32 BytesSent = 0;
+		if (!Client.Socket->Send(Bytes.GetData() + Client.SendOffset, Bytes.Num() - Client.SendOffset, BytesSent))
+		{
+			// A full send buffer is backpressure, not an error; the queue absorbs it
+			return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK;
+		}
+
+		Client.SendOffset += BytesSent;
+		if (Client.SendOffset < Bytes.Num())
+		{
+			return true;
+		}
+		Client.Sending.Reset();
+	}
+}
+
+void FMujocoStateStreamer::CloseClient(FClient& Client) const
+{
+	if (Client.Socket)
+	{
+		Client.Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Client.Socket);
+		Client.Socket = nullptr;
+	}
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoStepClock.h"
+
+
+namespace
+{
+	/** Time constant of the rate smoothing, in wall seconds */
+	constexpr double SmoothingSeconds = 1.0;
+}
+
+
+void FMujocoStepClock::Reset()
+{
+	Accumulated = 0.0;
+	FrameDeltaTime = 0.0;
+	Stats = FMujocoStepClockStats();
+}
+
+int32 FMujocoStepClock::BeginFrame(const double DeltaTime, const double Timestep, const EMujocoStepMode Mode, const double TimeScale, const int32 MaxStepsPerFrame, const double Rate)
+{
+	FrameDeltaTime = DeltaTime;
+	const int32 MaxSteps = FMath::Max(MaxStepsPerFrame, 1);
+	const double ClampedRate = FMath::Clamp(Rate, 0.0, 1.0);
+	if (Timestep <= 0.0)
+	{
+		return 0;
+	}
+
+	// Unbounded: the caller steps until its frame budget is spent, so the step cap does not apply
+	if (Mode == EMujocoStepMode::AsFastAsPossible)
+	{
+		Accumulated = 0.0;
+		return ClampedRate > 0.0 ? MAX_int32 : 0;
+	}
+
+	Accumulated += DeltaTime * ClampedRate * (Mode == EMujocoStepMode::Scaled ? FMath::Max(TimeScale, 0.0) : 1.0);
+
+	const int64 Owed = FMath::FloorToInt64(Accumulated / Timestep);
+	if (Owed > MaxSteps)
+	{
+		++Stats.CappedFrames;
+		return MaxSteps;
+	}
+
+	return static_cast<int32>(Owed);
+}
+
+void FMujocoStepClock::EndFrame(const int32 StepsTaken, const double Timestep)
+{
+	// Whole steps the frame did not get to (the cap, a diverged simulation) are dropped, not carried
+	if (Timestep > 0.0)
+	{
+		const double Owed = FMath::Max(Accumulated - StepsTaken * Timestep, 0.0);
+		Accumulated = FMath::Fmod(Owed, Timestep);
+		Stats.DroppedSeconds += Owed - Accumulated;
+	}
+
+	if (FrameDeltaTime <= 0.0)
+	{
+		return;
+	}
+
+	const double Weight = FMath::Min(FrameDeltaTime / SmoothingSeconds, 1.0);
+	Stats.StepsPerSecond += (StepsTaken / FrameDeltaTime - Stats.StepsPerSecond) * Weight;
+	Stats.RealtimeFactor = Stats.StepsPerSecond * Timestep;
+}
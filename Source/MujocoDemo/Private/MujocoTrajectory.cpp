@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoTrajectory.h"
+
+#include "MujocoAPI.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoTrajectory);
+
+
+FMujocoTrajectoryWriter::~FMujocoTrajectoryWriter()
+{
+	Close();
+}
+
+bool FMujocoTrajectoryWriter::Open(const FString& FilePath, const FMujocoAPI& Api, const mjModel* Model, const uint32 StateSpec, const uint32 FramesPerChunk)
+{
+	Close();
+
+	if (!Model || FramesPerChunk == 0)
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Cannot record trajectory without a model."));
+		return false;
+	}
+
+	Archive.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Archive)
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Failed to create trajectory file: %s"), *FilePath);
+		return false;
+	}
+
+	Header = FMujocoTrajectoryHeader();
+	Header.StateSpec = StateSpec | mjSTATE_TIME; // time is required for seeking
+	Header.StateSize = Api.GetStateSize(Model, Header.StateSpec);
+	Header.FramesPerChunk = FramesPerChunk;
+	Header.Nq = Model->nq;
+	Header.Nmocap = Model->nmocap;
+	Header.Timestep = Model->opt.timestep;
+
+	Chunks.Reset();
+	FrameScratch.SetNumUninitialized(Header.StateSize);
+	LastTime = 0.0;
+
+	// Placeholder, rewritten with the final counts in Close()
+	Archive->Serialize(&Header, sizeof(Header));
+
+	UE_LOG(LogMujocoTrajectory, Log, TEXT("Recording trajectory to %s (%u values per frame)"), *FilePath, Header.StateSize);
+	return true;
+}
+
+bool FMujocoTrajectoryWriter::Append(const FMujocoAPI& Api, const mjModel* Model, const mjData* Data)
+{
+	if (!Archive || !Model || !Data)
+	{
+		return false;
+	}
+
+	// Seeking relies on sorted frame times
+	if (Header.FrameCount > 0 && Data->time < LastTime)
+	{
+		UE_LOG(LogMujocoTrajectory, Warning, TEXT("Dropped a frame at t=%.4f: the recording is already at t=%.4f."), Data->time, LastTime);
+		return false;
+	}
+	LastTime = Data->time;
+
+	if (Header.FrameCount % Header.FramesPerChunk == 0)
+	{
+		FMujocoTrajectoryChunk& Chunk = Chunks.AddDefaulted_GetRef();
+		Chunk.StartTime = Data->time;
+		Chunk.FirstFrame = Header.FrameCount;
+	}
+
+	Api.GetState(Model, Data, FrameScratch.GetData(), Header.StateSpec);
+	Archive->Serialize(FrameScratch.GetData(), FrameScratch.Num() * sizeof(mjtNum));
+	++Header.FrameCount;
+	return true;
+}
+
+void FMujocoTrajectoryWriter::Close()
+{
+	if (!Archive)
+	{
+		return;
+	}
+
+	Header.IndexOffset = static_cast<uint64>(Archive->Tell());
+	Header.ChunkCount = Chunks.Num();
+	Archive->Serialize(Chunks.GetData(), Chunks.Num() * sizeof(FMujocoTrajectoryChunk));
+
+	Archive->Seek(0);
+	Archive->Serialize(&Header, sizeof(Header));
+	Archive->Close();
+	Archive.Reset();
+
+	UE_LOG(LogMujocoTrajectory, Log, TEXT("Closed trajectory with %llu frames in %u chunks"), Header.FrameCount, Header.ChunkCount);
+}
+
+
+FMujocoTrajectoryReader::~FMujocoTrajectoryReader()
+{
+	Close();
+}
+
+bool FMujocoTrajectoryReader::Open(const FString& FilePath, const FMujocoAPI& Api, const mjModel* Model)
+{
+	Close();
+
+	if (!Model)
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Cannot replay trajectory without a model."));
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	FOpenMappedResult OpenResult = PlatformFile.OpenMappedEx(*FilePath);
+	if (OpenResult.HasError())
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Failed to map trajectory %s: %s"), *FilePath, *OpenResult.GetError().GetMessage());
+		return false;
+	}
+
+	MappedFile = OpenResult.StealValue();
+	MappedRegion.Reset(MappedFile->MapRegion());
+	if (!MappedRegion || MappedRegion->GetMappedSize() < static_cast<int64>(sizeof(FMujocoTrajectoryHeader)))
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Trajectory file is empty or could not be mapped: %s"), *FilePath);
+		Close();
+		return false;
+	}
+
+	const uint8* Base = MappedRegion->GetMappedPtr();
+	const int64 MappedSize = MappedRegion->GetMappedSize();
+	FMemory::Memcpy(&Header, Base, sizeof(Header));
+
+	if (Header.Magic != FMujocoTrajectoryHeader::MagicValue || Header.Version != FMujocoTrajectoryHeader::CurrentVersion)
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Not a trajectory file (or unsupported version): %s"), *FilePath);
+		Close();
+		return false;
+	}
+
+	if (Header.Nq != Model->nq || Header.Nmocap != Model->nmocap ||
+		static_cast<int32>(Header.StateSize) != Api.GetStateSize(Model, Header.StateSpec))
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Trajectory %s was recorded with a different model (nq %d vs %d)."),
+			*FilePath, Header.Nq, Model->nq);
+		Close();
+		return false;
+	}
+
+	const uint64 FramesEnd = sizeof(FMujocoTrajectoryHeader) + Header.FrameCount * Header.StateSize * sizeof(mjtNum);
+	const uint64 IndexEnd = Header.IndexOffset + Header.ChunkCount * sizeof(FMujocoTrajectoryChunk);
+	if (Header.FrameCount == 0 || Header.ChunkCount == 0 || Header.IndexOffset < FramesEnd || IndexEnd > static_cast<uint64>(MappedSize))
+	{
+		UE_LOG(LogMujocoTrajectory, Error, TEXT("Trajectory %s is truncated or was not closed cleanly."), *FilePath);
+		Close();
+		return false;
+	}
+
+	Frames = reinterpret_cast<const mjtNum*>(Base + sizeof(FMujocoTrajectoryHeader));
+	Chunks = reinterpret_cast<const FMujocoTrajectoryChunk*>(Base + Header.IndexOffset);
+
+	UE_LOG(LogMujocoTrajectory, Log, TEXT("Mapped trajectory %s: %llu frames, %.3f s"), *FilePath, Header.FrameCount, GetEndTime() - GetStartTime());
+	return true;
+}
+
+void FMujocoTrajectoryReader::Close()
+{
+	Frames = nullptr;
+	Chunks = nullptr;
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Header = FMujocoTrajectoryHeader();
+}
+
+double FMujocoTrajectoryReader::GetStartTime() const
+{
+	return IsOpen() ? Frames[0] : 0.0;
+}
+
+double FMujocoTrajectoryReader::GetEndTime() const
+{
+	return IsOpen() ? Frames[(Header.FrameCount - 1) * Header.StateSize] : 0.0;
+}
+
+int64 FMujocoTrajectoryReader::FindFrame(const double Time) const
+{
+	if (!IsOpen())
+	{
+		return INDEX_NONE;
+	}
+
+	// Last chunk starting at or before Time, then the last frame in it at or before Time;
+	// frame times are sorted but not necessarily one timestep apart
+	const TConstArrayView<FMujocoTrajectoryChunk> ChunkView(Chunks, Header.ChunkCount);
+	const int32 ChunkIndex = FMath::Max(Algo::UpperBoundBy(ChunkView, Time, &FMujocoTrajectoryChunk::StartTime) - 1, 0);
+	const int64 First = static_cast<int64>(Chunks[ChunkIndex].FirstFrame);
+	const int64 End = ChunkIndex + 1 < ChunkView.Num() ? static_cast<int64>(Chunks[ChunkIndex + 1].FirstFrame) : GetFrameCount();
+
+	int64 Low = First;
+	int64 High = End;
+	while (Low < High)
+	{
+		const int64 Middle = Low + (High - Low) / 2;
+		if (GetFrameTime(Middle) <= Time)
+		{
+			Low = Middle + 1;
+		}
+		else
+		{
+			High = Middle;
+		}
+	}
+
+	// Low is the first frame after Time; pick whichever neighbour is nearer
+	const int64 Before = FMath::Max(Low - 1, First);
+	if (Low >= GetFrameCount() || (Low > First && Time - GetFrameTime(Before) <= GetFrameTime(Low) - Time))
+	{
+		return Before;
+	}
+	return Low;
+}
+
+const mjtNum* FMujocoTrajectoryReader::GetFrame(const int64 FrameIndex) const
+{
+	if (!IsOpen() || FrameIndex < 0 || FrameIndex >= GetFrameCount())
+	{
+		return nullptr;
+	}
+	return Frames + FrameIndex * Header.StateSize;
+}
+
+bool FMujocoTrajectoryReader::ApplyFrame(const int64 FrameIndex, const FMujocoAPI& Api, const mjModel* Model, mjData* Data) const
+{
+	const mjtNum* Frame = GetFrame(FrameIndex);
+	if (!Frame || !Model || !Data)
+	{
+		return false;
+	}
+
+	Api.SetState(Model, Data, Frame, Header.StateSpec);
+	return true;
+}
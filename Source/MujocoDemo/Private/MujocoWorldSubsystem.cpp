@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "MujocoWorldSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "MujocoManager.h"
+
+
+DEFINE_LOG_CATEGORY(LogMujocoWorlds);
+
+DECLARE_STATS_GROUP(TEXT("MuJoCo"), STATGROUP_Mujoco, STATCAT_Advanced);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("LOD steps/s saved"), STAT_MujocoLODStepsSaved, STATGROUP_Mujoco);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frozen worlds"), STAT_MujocoFrozenWorlds, STATGROUP_Mujoco);
+
+
+void UMujocoWorldSubsystem::RegisterManager(AMujocoManager* Manager)
+{
+	if (Manager)
+	{
+		Managers.AddUnique(Manager);
+		UE_LOG(LogMujocoWorlds, Log, TEXT("Registered %s (%d worlds)."), *Manager->GetName(), Managers.Num());
+	}
+}
+
+void UMujocoWorldSubsystem::UnregisterManager(AMujocoManager* Manager)
+{
+	Managers.Remove(Manager);
+}
+
+bool UMujocoWorldSubsystem::GetViewLocation(const UWorld* World, FVector& OutLocation)
+{
+	const APlayerController* Controller = World ? World->GetFirstPlayerController() : nullptr;
+	if (!Controller || !Controller->PlayerCameraManager)
+	{
+		return false;
+	}
+
+	OutLocation = Controller->PlayerCameraManager->GetCameraLocation();
+	return true;
+}
+
+void UMujocoWorldSubsystem::Deinitialize()
+{
+	Managers.Empty();
+	Super::Deinitialize();
+}
+
+void UMujocoWorldSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	Managers.RemoveAll([](const TObjectPtr<AMujocoManager>& Manager) { return !IsValid(Manager); });
+	FrameStats = FMujocoWorldFrameStats();
+	FrameStats.NumWorlds = Managers.Num();
+	if (Managers.IsEmpty())
+	{
+		return;
+	}
+
+	// A level change resets the manager's step clock and pose buffer, so levels change before any worker starts
+	FVector ViewLocation;
+	if (GetViewLocation(GetWorld(), ViewLocation))
+	{
+		for (AMujocoManager* Manager : Managers)
+		{
+			Manager->UpdateSimulationLOD(ViewLocation);
+		}
+	}
+
+	// Managers share no simulation state, so each steps on its own worker
+	WorldMilliseconds.SetNumZeroed(Managers.Num());
+	const double StepStart = FPlatformTime::Seconds();
+	ParallelFor(Managers.Num(), [this, DeltaTime](const int32 Index)
+	{
+		const double WorldStart = FPlatformTime::Seconds();
+		Managers[Index]->AdvanceSimulation(DeltaTime);
+		WorldMilliseconds[Index] = (FPlatformTime::Seconds() - WorldStart) * 1000.0;
+	}, Managers.Num() < 2 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+	FrameStats.StepMilliseconds = (FPlatformTime::Seconds() - StepStart) * 1000.0;
+
+	for (int32 Index = 0; Index < Managers.Num(); ++Index)
+	{
+		FrameStats.SlowestWorldMilliseconds = FMath::Max(FrameStats.SlowestWorldMilliseconds, WorldMilliseconds[Index]);
+		FrameStats.TotalWorldMilliseconds += WorldMilliseconds[Index];
+
+		const AMujocoManager* Manager = Managers[Index];
+		FrameStats.LODStepsSavedPerSecond += Manager->GetLODStepsSavedPerSecond();
+		FrameStats.NumMidWorlds += Manager->GetSimulationLOD() == EMujocoSimulationLOD::Mid;
+		FrameStats.NumFarWorlds += Manager->GetSimulationLOD() == EMujocoSimulationLOD::Far;
+		FrameStats.NumFrozenWorlds += Manager->IsSimulationFrozen();
+	}
+	SET_FLOAT_STAT(STAT_MujocoLODStepsSaved, FrameStats.LODStepsSavedPerSecond);
+	SET_DWORD_STAT(STAT_MujocoFrozenWorlds, FrameStats.NumFrozenWorlds);
+
+	// Components, sensors and debug lines are game-thread objects; sync them all after the join
+	const double SyncStart = FPlatformTime::Seconds();
+	for (AMujocoManager* Manager : Managers)
+	{
+		Manager->SyncToScene(DeltaTime);
+	}
+	FrameStats.SyncMilliseconds = (FPlatformTime::Seconds() - SyncStart) * 1000.0;
+}
+
+TStatId UMujocoWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMujocoWorldSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "MujocoAPI.h"
+#include "MujocoDeterminism.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+namespace
+{
+	constexpr int32 TestSteps = 200;
+
+	/** Step a fresh data of Model TestSteps times and return the hash of the final state */
+	uint64 RunSteps(FAutomationTestBase& Test, const FMujocoAPI& Api, const mjModel* Model, const FString& Name)
+	{
+		mjData* Data = Api.CreateData(Model);
+		if (!Test.TestNotNull(FString::Printf(TEXT("%s data"), *Name), Data))
+		{
+			return 0;
+		}
+
+		for (int32 Step = 0; Step < TestSteps; ++Step)
+		{
+			Api.Step(Model, Data);
+		}
+		Test.TestEqual(FString::Printf(TEXT("%s time after %d steps"), *Name, TestSteps), Data->time, TestSteps * Model->opt.timestep, 1e-9);
+
+		const uint64 Hash = FMujocoDeterminismChecker::HashState(Model, Data);
+		Api.FreeData(Data);
+		return Hash;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMujocoReferenceModelsTest, "MujocoDemo.Benchmarks.ReferenceModels",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::CommandletContext | EAutomationTestFlags::ProductFilter)
+
+bool FMujocoReferenceModelsTest::RunTest(const FString& Parameters)
+{
+	FMujocoAPI Api;
+	if (!TestTrue(TEXT("MuJoCo library loaded"), Api.LoadMuJoCo()))
+	{
+		return false;
+	}
+
+	const FString BenchmarkDir = FPaths::Combine(FPaths::ProjectPluginsDir(), TEXT("mujoco"), TEXT("Resources"), TEXT("Benchmarks"));
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *FPaths::Combine(BenchmarkDir, TEXT("*.xml")), true, false);
+	TestTrue(TEXT("Reference models found"), !Files.IsEmpty());
+
+	for (const FString& File : Files)
+	{
+		const FString Name = FPaths::GetBaseFilename(File);
+		mjModel* Model = Api.LoadModelFromXML(FPaths::Combine(BenchmarkDir, File));
+		if (!TestNotNull(FString::Printf(TEXT("%s compiles"), *Name), Model))
+		{
+			continue;
+		}
+
+		// Two runs from the same initial state must end bit-for-bit identical
+		const uint64 First = RunSteps(*this, Api, Model, Name);
+		const uint64 Second = RunSteps(*this, Api, Model, Name);
+		TestEqual(FString::Printf(TEXT("%s state hash is reproducible"), *Name), Second, First);
+
+		Api.FreeModel(Model);
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MujocoBenchmarkCommandlet.generated.h"
+
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoBenchmark, Log, All);
+
+
+/**
+ * Headless performance regression check over the reference models in
+ * Plugins/mujoco/Resources/Benchmarks.
+ *
+ * For every model it measures compile time (CompileMs), the manager's full LoadModel (compile,
+ * binding and component creation; LoadModelMs), physics steps per second and the cost of one
+ * UpdateMuJoCoObjects, then compares them with Baselines.json in the same directory. Exits
+ * non-zero when any metric is worse than its baseline by more than the metric's tolerance, or
+ * has no baseline.
+ *
+ *   UnrealEditor-Cmd MujocoDemo.uproject -run=MujocoBenchmark -unattended -nullrhi
+ *     [-Models=box,humanoid] [-Steps=2000] [-Syncs=200] [-Baselines=<path>] [-UpdateBaselines]
+ *
+ * -UpdateBaselines records this run as the new baseline of the models it ran, keeping the
+ * tolerances and the baselines of other models. Baselines are machine-specific, so none are
+ * shipped; record them on the machine that runs the check before relying on it. Results of
+ * every run are also written to Saved/Benchmarks.
+ */
+UCLASS()
+class MUJOCODEMO_API UMujocoBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMujocoBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "MujocoContacts.generated.h"
+
+class FMujocoAPI;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoContacts, Log, All);
+
+
+/** One active contact, in MuJoCo world units */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoContact
+{
+	GENERATED_BODY()
+
+	/** Geom ids; -1 for flex contacts */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	int32 Geom1 = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	int32 Geom2 = INDEX_NONE;
+
+	/** Bodies owning the geoms; -1 for flex contacts */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	int32 Body1 = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	int32 Body2 = INDEX_NONE;
+
+	/** Midpoint between the two surfaces */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	FVector Position = FVector::ZeroVector;
+
+	/** Unit normal pointing from geom 1 to geom 2 */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	FVector Normal = FVector::ZeroVector;
+
+	/** World-frame force geom 1 exerts on geom 2 */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	FVector Force = FVector::ZeroVector;
+
+	/** Force along the normal; positive pushes the geoms apart */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	double NormalForce = 0.0;
+
+	/** Signed surface distance; negative means penetration */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	double Distance = 0.0;
+};
+
+/** Totals over the contacts between two bodies (or one body and anything) in the latest extraction */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoContactPairStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	int32 NumContacts = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Contacts")
+	double NormalForce = 0.0;
+};
+
+/**
+ * Pulls mjData::contact into a packed array once per step, resolving bodies and forces.
+ *
+ * Buffers are sized for the largest contact count seen and reused, so extraction does not
+ * allocate in steady state. Per-body normal force totals and any registered body-pair
+ * filters are accumulated during the same pass over the contacts.
+ *
+ * Filters outlive a rebind. Bind finds their bodies again by name, since a scene edit can
+ * renumber them; a filter whose body is gone or was unnamed stops matching until a later
+ * model has it again.
+ */
+class MUJOCODEMO_API FMujocoContactQuery
+{
+public:
+	void Bind(const mjModel* InModel);
+	void Reset();
+
+	/** Register a pair to aggregate; INDEX_NONE for BodyB matches any other body. Returns the filter index. */
+	int32 AddPairFilter(int32 BodyA, int32 BodyB = INDEX_NONE);
+	void ClearPairFilters();
+
+	/** Refresh everything from Data; call after a step so contact forces are solved */
+	void Extract(const FMujocoAPI& Api, const mjModel* Model, const mjData* Data);
+
+	TArrayView<const FMujocoContact> GetContacts() const { return Contacts; }
+
+	/** Sum of the normal force on each body, indexed by body id */
+	TArrayView<const double> GetBodyNormalForces() const { return BodyNormalForces; }
+
+	double GetBodyNormalForce(const int32 Body) const { return BodyNormalForces.IsValidIndex(Body) ? BodyNormalForces[Body] : 0.0; }
+
+	int32 GetNumPairFilters() const { return PairFilters.Num(); }
+
+	/** Totals of a filter in the latest extraction; empty for an invalid index */
+	const FMujocoContactPairStats& GetPairStats(int32 Filter) const;
+
+	/** Indices into GetContacts() of the contacts between BodyA and BodyB (any body if INDEX_NONE) */
+	void FindContacts(int32 BodyA, int32 BodyB, TArray<int32>& OutIndices) const;
+
+private:
+	/** Body id of a filter side whose body is not in the bound model; matches no contact */
+	static constexpr int32 UnresolvedBody = -2;
+
+	struct FPairFilter
+	{
+		int32 BodyA;
+		int32 BodyB;
+
+		/** Body names in the model the filter was added with; empty if unnamed */
+		FString NameA;
+		FString NameB;
+
+		/** Added before any model was bound, so the ids are all there is to go on */
+		bool bUnnamedIds = false;
+	};
+
+	/** Find Id's body again in Model by Name; Id itself if it is a wildcard or there are no names to go on */
+	static int32 ResolveBody(const mjModel* Model, int32 Id, const FString& Name, bool bUnnamedIds);
+
+	const mjModel* Model = nullptr;
+
+	static bool Matches(const FPairFilter& Filter, int32 Body1, int32 Body2)
+	{
+		return (Body1 == Filter.BodyA && (Filter.BodyB == INDEX_NONE || Body2 == Filter.BodyB))
+			|| (Body2 == Filter.BodyA && (Filter.BodyB == INDEX_NONE || Body1 == Filter.BodyB));
+	}
+
+	TArray<FMujocoContact> Contacts;
+	TArray<double> BodyNormalForces;
+	TArray<FPairFilter> PairFilters;
+	TArray<FMujocoContactPairStats> PairStats;
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+
+/**
+ * Staging area for actuator controls.
+ *
+ * Any number of sources (Blueprint, input, policies, scripted trajectories) write into a
+ * preallocated staging copy of ctrl from any thread. At the start of each physics step the
+ * manager applies it to mjData in one locked copy, so a step never sees half of an update.
+ *
+ * Every write that changes the staging buffer starts a new control tick; writes of the values
+ * already staged do not, so sources may restage every step. With a non-zero interpolation
+ * time the applied controls ramp from their values at the tick to the new targets over that
+ * much simulated time, which smooths policies running slower than physics.
+ */
+class MUJOCODEMO_API FMujocoControlBuffer
+{
+public:
+	/** Size the buffers for Model's actuators and take the initial targets from Data */
+	void Initialize(const mjModel* Model, const mjData* Data);
+	void Release();
+
+	bool IsInitialized() const { return Staged.Num() > 0; }
+	int32 Num() const { return Staged.Num(); }
+
+	/** Stage Values for actuators FirstActuator .. FirstActuator + Values.Num() - 1 */
+	void SetControls(TConstArrayView<double> Values, int32 FirstActuator = 0);
+
+	void SetControl(int32 Actuator, double Value);
+
+	/** Copy of the staged targets */
+	void GetStagedControls(TArray<double>& OutValues) const;
+
+	/** Drop any ramp in progress and take the current controls in Data as the targets */
+	void Reset(const mjData* Data);
+
+	/** Seconds of simulated time over which a new tick is blended in; 0 applies targets immediately */
+	void SetInterpolationTime(const double Seconds) { InterpolationTime = FMath::Max(Seconds, 0.0); }
+
+	/** Write the controls for the coming step into Data->ctrl */
+	void Apply(mjData* Data);
+
+private:
+	mutable FCriticalSection Lock;
+
+	/** Written by sources under Lock */
+	TArray<double> Staged;
+	bool bDirty = false;
+
+	/** Owned by the stepping thread */
+	TArray<double> From;
+	TArray<double> Target;
+	double TickTime = 0.0;
+	double InterpolationTime = 0.0;
+};
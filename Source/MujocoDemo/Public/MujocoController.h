@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoController, Log, All);
+
+
+/**
+ * Native controller run by AMujocoManager right before every mj_step, after the staged
+ * controls have been applied, so it runs at the physics rate whatever the frame rate.
+ *
+ * Compute() is on the simulation hot path: it must not allocate, and should only read state
+ * from Data and write Data->ctrl. Size everything it needs in Bind().
+ */
+class MUJOCODEMO_API IMujocoController
+{
+public:
+	virtual ~IMujocoController() = default;
+
+	/**
+	 * Resolve ids and preallocate for Model. Returning false keeps the controller from running.
+	 * After a scene edit it is called again without Unbind; keep the settings that still apply.
+	 */
+	virtual bool Bind(const mjModel* Model) { return true; }
+
+	/** Drop anything that refers to the model being unloaded */
+	virtual void Unbind() {}
+
+	virtual void Compute(const mjModel* Model, mjData* Data) = 0;
+};
+
+/** Proportional and derivative gain for one actuator; an actuator with both gains at zero is left alone */
+struct FMujocoPDGains
+{
+	double Kp = 0.0;
+	double Kd = 0.0;
+};
+
+/**
+ * Common part of the built-in joint-space PD controllers. Each actuator with a hinge or slide
+ * joint transmission can be given gains and a target; the controller overwrites its ctrl.
+ * Use with motor actuators, where ctrl is a force or torque.
+ *
+ * Gains and targets are plain arrays indexed by actuator id, sized in Bind(); set them from
+ * the thread that steps the simulation. Binding again, e.g. after a scene edit, keeps the
+ * settings of every actuator whose joint is still in the model by name and resets the rest;
+ * Unbind() clears them all.
+ */
+class MUJOCODEMO_API FMujocoJointPDController : public IMujocoController
+{
+public:
+	virtual bool Bind(const mjModel* Model) override;
+	virtual void Unbind() override;
+
+	void SetGains(int32 Actuator, const FMujocoPDGains& InGains);
+
+	/** Same gains for every actuator driving a hinge or slide joint */
+	void SetAllGains(const FMujocoPDGains& InGains);
+
+	void SetTarget(int32 Actuator, double Target);
+	void SetTargets(TConstArrayView<double> InTargets, int32 FirstActuator = 0);
+
+	TArrayView<const double> GetTargets() const { return Targets; }
+
+protected:
+	TArray<FMujocoPDGains> Gains;
+	TArray<double> Targets;
+
+	/** qpos and dof address of the joint each actuator drives, INDEX_NONE if unsupported */
+	TArray<int32> QposAddresses;
+	TArray<int32> DofAddresses;
+
+	/** Name of the joint each actuator drives, empty if unsupported or unnamed; case-sensitive like MuJoCo's */
+	TArray<FString> JointNames;
+};
+
+/** ctrl = Kp * (target - q) - Kd * qdot */
+class MUJOCODEMO_API FMujocoPDPositionController : public FMujocoJointPDController
+{
+public:
+	virtual void Compute(const mjModel* Model, mjData* Data) override;
+};
+
+/** ctrl = Kp * (target - qdot) + Kd * d(target - qdot)/dt, with the derivative taken across steps */
+class MUJOCODEMO_API FMujocoPDVelocityController : public FMujocoJointPDController
+{
+public:
+	virtual bool Bind(const mjModel* Model) override;
+	virtual void Compute(const mjModel* Model, mjData* Data) override;
+
+private:
+	TArray<double> PreviousErrors;
+	double PreviousTime = -1.0;
+};
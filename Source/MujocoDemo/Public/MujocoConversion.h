@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjtnum.h>
+
+#include "CoreMinimal.h"
+#include "MujocoConversion.generated.h"
+
+
+/** How MuJoCo's axes map onto Unreal's */
+UENUM(BlueprintType)
+enum class EMujocoAxisConvention : uint8
+{
+	/** MuJoCo's right-handed Z-up frame shown unmirrored in Unreal's left-handed Z-up frame, by negating Y */
+	ZUp,
+
+	/** Models authored Y up (gravity along -Y): MuJoCo Y becomes Unreal Z, -Z becomes Unreal X */
+	YUp,
+
+	/** Axes copied as they are; the scene appears mirrored */
+	Unconverted,
+};
+
+/**
+ * Compile-time description of one axis convention as a signed permutation P:
+ * Unreal[i] = Sign[i] * MuJoCo[Source[i]].
+ *
+ * Rotations become P R D, where D flips the local axis LocalSign names so the result is a proper
+ * rotation even though P mirrors. Component-local axes thus stay MuJoCo's geom-local axes, up to
+ * the sign of one axis, so geom sizes need no permuting and symmetric primitives need nothing
+ * else; mesh vertices are multiplied by D. As a quaternion this is the vector part permuted by
+ * P (times det P), followed by the constant Correction, the rotation P D.
+ */
+namespace MujocoConversion
+{
+	template <EMujocoAxisConvention Convention>
+	struct TAxes;
+
+	template <>
+	struct TAxes<EMujocoAxisConvention::ZUp>
+	{
+		static constexpr int32 Source[3] = { 0, 1, 2 };
+		static constexpr double Sign[3] = { 1.0, -1.0, 1.0 };
+		static constexpr double LocalSign[3] = { 1.0, -1.0, 1.0 };
+		static constexpr double Det = -1.0;
+
+		/** P D is the identity here */
+		static constexpr double Correction[4] = { 0.0, 0.0, 0.0, 1.0 };
+	};
+
+	template <>
+	struct TAxes<EMujocoAxisConvention::YUp>
+	{
+		static constexpr int32 Source[3] = { 2, 0, 1 };
+		static constexpr double Sign[3] = { -1.0, 1.0, 1.0 };
+		static constexpr double LocalSign[3] = { 1.0, 1.0, -1.0 };
+		static constexpr double Det = -1.0;
+
+		/** P D cycles X -> Y -> Z: 120 degrees about (1, 1, 1) */
+		static constexpr double Correction[4] = { 0.5, 0.5, 0.5, 0.5 };
+	};
+
+	template <>
+	struct TAxes<EMujocoAxisConvention::Unconverted>
+	{
+		static constexpr int32 Source[3] = { 0, 1, 2 };
+		static constexpr double Sign[3] = { 1.0, 1.0, 1.0 };
+		static constexpr double LocalSign[3] = { 1.0, 1.0, 1.0 };
+		static constexpr double Det = 1.0;
+		static constexpr double Correction[4] = { 0.0, 0.0, 0.0, 1.0 };
+	};
+
+	template <typename Axes>
+	FORCEINLINE FVector ToUnrealPosition(const mjtNum* Position, const double Scale)
+	{
+		return FVector(
+			Axes::Sign[0] * Position[Axes::Source[0]] * Scale,
+			Axes::Sign[1] * Position[Axes::Source[1]] * Scale,
+			Axes::Sign[2] * Position[Axes::Source[2]] * Scale);
+	}
+
+	template <typename Axes>
+	FORCEINLINE FVector ToUnrealPosition(const FVector& Position, const double Scale)
+	{
+		return FVector(
+			Axes::Sign[0] * Position[Axes::Source[0]] * Scale,
+			Axes::Sign[1] * Position[Axes::Source[1]] * Scale,
+			Axes::Sign[2] * Position[Axes::Source[2]] * Scale);
+	}
+
+	/** Rotation of a geom or body given as a MuJoCo quaternion stored in an FQuat */
+	template <typename Axes>
+	FORCEINLINE FQuat ToUnrealRotation(const FQuat& Rotation)
+	{
+		const double Vector[3] = { Rotation.X, Rotation.Y, Rotation.Z };
+		const FQuat Permuted(
+			Axes::Det * Axes::Sign[0] * Vector[Axes::Source[0]],
+			Axes::Det * Axes::Sign[1] * Vector[Axes::Source[1]],
+			Axes::Det * Axes::Sign[2] * Vector[Axes::Source[2]],
+			Rotation.W);
+		return Permuted * FQuat(Axes::Correction[0], Axes::Correction[1], Axes::Correction[2], Axes::Correction[3]);
+	}
+
+	/** Mesh vertex in MuJoCo mesh-local coordinates */
+	template <typename Axes>
+	FORCEINLINE FVector3d ToUnrealVertex(const float* Vertex, const double Scale)
+	{
+		return FVector3d(
+			Axes::LocalSign[0] * Vertex[0] * Scale,
+			Axes::LocalSign[1] * Vertex[1] * Scale,
+			Axes::LocalSign[2] * Vertex[2] * Scale);
+	}
+
+	template <typename Axes>
+	FORCEINLINE FVector ToMujocoPosition(const FVector& Position, const double Scale)
+	{
+		double Out[3];
+		Out[Axes::Source[0]] = Axes::Sign[0] * Position.X / Scale;
+		Out[Axes::Source[1]] = Axes::Sign[1] * Position.Y / Scale;
+		Out[Axes::Source[2]] = Axes::Sign[2] * Position.Z / Scale;
+		return FVector(Out[0], Out[1], Out[2]);
+	}
+
+	template <typename Axes>
+	FORCEINLINE FQuat ToMujocoRotation(const FQuat& Rotation)
+	{
+		const FQuat Permuted = Rotation * FQuat(Axes::Correction[0], Axes::Correction[1], Axes::Correction[2], Axes::Correction[3]).Inverse();
+		double Out[3];
+		Out[Axes::Source[0]] = Axes::Det * Axes::Sign[0] * Permuted.X;
+		Out[Axes::Source[1]] = Axes::Det * Axes::Sign[1] * Permuted.Y;
+		Out[Axes::Source[2]] = Axes::Det * Axes::Sign[2] * Permuted.Z;
+		return FQuat(Out[0], Out[1], Out[2], Permuted.W);
+	}
+
+	/** MuJoCo quaternion of a row-major 3x3 rotation such as geom_xmat, still in MuJoCo axes */
+	FORCEINLINE FQuat MatrixToQuat(const mjtNum* Mat)
+	{
+		// FMatrix rows are the images of the basis vectors, i.e. the columns of Mat
+		return FMatrix(
+			FVector(Mat[0], Mat[3], Mat[6]),
+			FVector(Mat[1], Mat[4], Mat[7]),
+			FVector(Mat[2], Mat[5], Mat[8]),
+			FVector::ZeroVector).ToQuat();
+	}
+}
+
+/**
+ * Units and axes between MuJoCo and Unreal, for everything placed in the level.
+ *
+ * The per-value functions switch on the convention each call and suit one-off conversions.
+ * Loops over many geoms or vertices should call Dispatch once and use the MujocoConversion
+ * kernels with the axes it passes in, so the inner loop is specialized and has no branches.
+ */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoConversion
+{
+	GENERATED_BODY()
+
+	/** Unreal units per MuJoCo length unit; 100 for models in meters */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Conversion", meta=(ClampMin="0.0001"))
+	double UnitScale = 100.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Conversion")
+	EMujocoAxisConvention Axes = EMujocoAxisConvention::ZUp;
+
+	/** Call Func with a MujocoConversion::TAxes<> instance for the current convention */
+	template <typename FuncType>
+	decltype(auto) Dispatch(FuncType&& Func) const
+	{
+		switch (Axes)
+		{
+		case EMujocoAxisConvention::YUp:
+			return Func(MujocoConversion::TAxes<EMujocoAxisConvention::YUp>());
+		case EMujocoAxisConvention::Unconverted:
+			return Func(MujocoConversion::TAxes<EMujocoAxisConvention::Unconverted>());
+		default:
+			return Func(MujocoConversion::TAxes<EMujocoAxisConvention::ZUp>());
+		}
+	}
+
+	FVector ToUnrealPosition(const mjtNum* Position) const;
+	FVector ToUnrealPosition(const FVector& Position) const;
+
+	/** Directions and other unscaled vectors, e.g. forces and joint axes */
+	FVector ToUnrealDirection(const FVector& Direction) const;
+
+	FQuat ToUnrealRotation(const FQuat& Rotation) const;
+	FQuat ToUnrealRotation(const mjtNum* Mat) const { return ToUnrealRotation(MujocoConversion::MatrixToQuat(Mat)); }
+
+	FVector ToMujocoPosition(const FVector& Position) const;
+	FQuat ToMujocoRotation(const FQuat& Rotation) const;
+
+	/** Geom sizes stay in geom-local order; only the unit changes */
+	FVector ToUnrealSize(const FVector& Size) const { return Size * UnitScale; }
+	FVector ToMujocoSize(const FVector& Size) const { return Size / UnitScale; }
+
+	/** Whether converted mesh vertices are mirrored, so triangles must be wound the other way */
+	bool FlipsWinding() const { return Axes != EMujocoAxisConvention::Unconverted; }
+};
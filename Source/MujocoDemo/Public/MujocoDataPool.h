@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <memory>
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+class FMujocoAPI;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoDataPool, Log, All);
+
+/**
+ * Recycles mjData instances per model so that resetting, rewinding and batched
+ * environments of a loaded model reuse existing arenas instead of going through
+ * mj_makeData/mj_deleteData. Arenas do not outlive their model: ReleaseModel frees them.
+ *
+ * Pools are keyed by model pointer and a generation the pool assigns on first use, so
+ * ReleaseModel() must be called before a model is freed. A model later allocated at the same
+ * address starts a new generation and never sees instances of the old one, even those still
+ * out when it was released. Acquire and Release are safe to call from worker threads.
+ */
+class MUJOCODEMO_API FMujocoDataPool
+{
+public:
+	explicit FMujocoDataPool(std::shared_ptr<FMujocoAPI> InApi);
+	~FMujocoDataPool();
+
+	/** Take an mjData for Model, allocating only if none is pooled. Reset data is in the mj_resetData state. */
+	mjData* Acquire(const mjModel* Model, bool bReset = true);
+
+	/** Return Data to the pool of Model */
+	void Release(const mjModel* Model, mjData* Data);
+
+	/** Free every pooled instance of Model. Instances still acquired are freed when released. */
+	void ReleaseModel(const mjModel* Model);
+
+	/** Free the pooled instances of Model but keep its pool open; call after mj_recompile resizes Model in place */
+	void Trim(const mjModel* Model);
+
+	const std::shared_ptr<FMujocoAPI>& GetApi() const { return Api; }
+
+	/** Acquire counters; read under the lock since rollout workers acquire concurrently */
+	uint64 GetHits() const;
+	uint64 GetMisses() const;
+
+	/** Fraction of Acquire calls served without allocating */
+	double GetHitRate() const;
+
+private:
+	using FPoolKey = TTuple<const mjModel*, uint64>;
+
+	struct FModelPool
+	{
+		TArray<mjData*> Free;
+		int32 Outstanding = 0;
+		bool bReleased = false;
+	};
+
+	/** Key of Model's current pool, opening one under a new generation if it has none; call with Lock held */
+	FPoolKey FindOrAddKey(const mjModel* Model);
+
+	std::shared_ptr<FMujocoAPI> Api;
+
+	mutable FCriticalSection Lock;
+	TMap<FPoolKey, FModelPool> Pools;
+
+	/** Generation of every model with an open pool */
+	TMap<const mjModel*, uint64> Generations;
+
+	/** Pool each acquired instance came from, so it goes back to that one */
+	TMap<mjData*, FPoolKey> Owners;
+	uint64 NextGeneration = 1;
+	uint64 Hits = 0;
+	uint64 Misses = 0;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "MujocoConversion.h"
+#include "Components/LineBatchComponent.h"
+
+class FMujocoContactQuery;
+
+
+/** What FMujocoDebugDraw should show and how */
+struct FMujocoDebugDrawOptions
+{
+	bool bContacts = true;
+	bool bContactForces = true;
+	bool bCentersOfMass = false;
+	bool bJointAxes = false;
+
+	/** MuJoCo to Unreal units and axes */
+	FMujocoConversion Conversion;
+
+	/** Unreal units of arrow per Newton */
+	double ForceScale = 1.0;
+
+	/** Half size of the contact and center-of-mass markers, in Unreal units */
+	double MarkerSize = 2.0;
+
+	/** Length of a joint axis line, in Unreal units */
+	double AxisLength = 10.0;
+
+	float Thickness = 0.5f;
+
+	/** Upper bound on lines per frame; dense categories are subsampled evenly to fit */
+	int32 MaxLines = 20000;
+};
+
+/**
+ * Builds the debug lines for one frame into a reused buffer and submits them to a
+ * ULineBatchComponent in a single call.
+ *
+ * When a category has more items than its share of the line budget, every Nth item is drawn
+ * instead of the first few, so the picture of a dense contact patch stays representative.
+ */
+class MUJOCODEMO_API FMujocoDebugDraw
+{
+public:
+	/** Rebuild the line buffer; Contacts may be null when contact extraction is off */
+	void Build(const mjModel* Model, const mjData* Data, const FMujocoContactQuery* Contacts, const FMujocoDebugDrawOptions& Options);
+
+	/** Replace everything LineBatcher shows with the current buffer */
+	void Submit(ULineBatchComponent* LineBatcher);
+
+	/** Items skipped to stay within the budget in the last Build */
+	int32 GetNumSkipped() const { return NumSkipped; }
+
+private:
+	void AddLine(const FVector& Start, const FVector& End, const FLinearColor& Color, float Thickness);
+	void AddCross(const FVector& Center, double HalfSize, const FLinearColor& Color, float Thickness);
+
+	TArray<FBatchedLine> Lines;
+	int32 NumSkipped = 0;
+};
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MujocoDepthCameraComponent.generated.h"
+
+class AMujocoManager;
+class FMujocoAPI;
+class FMujocoRayTracer;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoDepthCamera, Log, All);
+
+
+/**
+ * Depth image rendered on the CPU from a camera defined in the MuJoCo model.
+ *
+ * Pose and vertical field of view come from the model's cam_* data, so the image matches
+ * what MuJoCo's own renderer would produce for that camera. Pixels are traced through the
+ * manager's shared FMujocoRayTracer in tiles spread across the task graph.
+ */
+UCLASS(ClassGroup=(MuJoCo), meta=(BlueprintSpawnableComponent))
+class MUJOCODEMO_API UMujocoDepthCameraComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMujocoDepthCameraComponent();
+
+	/** Latest depth image, row-major from the top-left pixel, in MuJoCo units along the optical axis; MaxRange where nothing was hit */
+	TArrayView<const float> GetDepth() const { return Depth; }
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|DepthCamera")
+	void CopyDepth(TArray<float>& OutDepth) const;
+
+	/** Width of the depth image, as of the last BindToModel */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|DepthCamera")
+	int32 GetWidth() const { return ImageWidth; }
+
+	/** Height of the depth image, as of the last BindToModel */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|DepthCamera")
+	int32 GetHeight() const { return ImageHeight; }
+
+	/** Resolve the camera and precompute the per-pixel rays in the camera frame */
+	bool BindToModel(const FMujocoAPI& Api, const mjModel* Model);
+	void Unbind();
+
+	bool IsBound() const { return Model != nullptr; }
+
+	/** Render a depth image from the camera pose in Source. Tracer must have been prepared for Source. */
+	void Render(const FMujocoRayTracer& Tracer, const mjData* Source);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Manager simulating the world this camera lives in; defaults to the owning actor */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|DepthCamera")
+	TObjectPtr<AMujocoManager> Manager;
+
+	/** Name of the <camera> in the MuJoCo model */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|DepthCamera")
+	FName CameraName;
+
+	/** Image resolution; a change takes effect the next time the camera is bound to a model */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|DepthCamera", meta=(ClampMin="1"))
+	int32 Width = 320;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|DepthCamera", meta=(ClampMin="1"))
+	int32 Height = 240;
+
+	/** Far clip in MuJoCo units */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|DepthCamera", meta=(ClampMin="0.0"))
+	double MaxRange = 10.0;
+
+	/** Bit i enables geom group i (MuJoCo has 6 groups) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|DepthCamera")
+	uint8 GeomGroupMask = 0x3F;
+
+private:
+	const mjModel* Model = nullptr;
+	int32 CameraId = -1;
+
+	/** Width and Height when LocalDirections and Depth were sized */
+	int32 ImageWidth = 0;
+	int32 ImageHeight = 0;
+
+	/** Unit ray per pixel in the camera frame; -Z is the optical axis, so depth is the hit distance times -Z */
+	TArray<FVector3d> LocalDirections;
+
+	TArray<float> Depth;
+};
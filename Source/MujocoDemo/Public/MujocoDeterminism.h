@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoDeterminism, Log, All);
+
+/**
+ * On-disk layout of a state hash stream:
+ *
+ *   [Header][Entry 0][Entry 1]...
+ *
+ * One entry per physics step. Entries carry their step number, so a stream written across a
+ * rewind or reset still lines up with a reference by step.
+ */
+struct FMujocoStateHashHeader
+{
+	static constexpr uint32 MagicValue = 0x48444A4D; // "MJDH"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = MagicValue;
+	uint32 Version = CurrentVersion;
+	int32 Nq = 0;
+	int32 Nv = 0;
+	int32 Na = 0;
+	uint32 Reserved = 0;
+};
+
+struct FMujocoStateHashEntry
+{
+	int64 Step = 0;
+	uint64 Hash = 0;
+};
+
+/**
+ * Hashes qpos, qvel and act after every step to check that runs are bit-for-bit reproducible.
+ *
+ * The hash stream of one run can be logged and later used as the reference for another. The
+ * first step whose hash differs from the reference is reported once; later steps would only
+ * repeat the divergence. Hashing is xxHash64 over the raw bytes, so -0.0 and 0.0 or two NaN
+ * payloads count as different, which is the point for a determinism check.
+ */
+class MUJOCODEMO_API FMujocoDeterminismChecker
+{
+public:
+	~FMujocoDeterminismChecker();
+
+	/** xxHash64 of qpos, qvel and act */
+	static uint64 HashState(const mjModel* Model, const mjData* Data);
+
+	/** Write the hash of every observed step to FilePath. Closes any previous log. */
+	bool OpenLog(const FString& FilePath, const mjModel* Model);
+	void CloseLog();
+
+	/** Compare every observed step against the stream in FilePath, recorded with the same model */
+	bool LoadReference(const FString& FilePath, const mjModel* Model);
+	void ClearReference();
+
+	bool IsLogging() const { return Archive.IsValid(); }
+	bool HasReference() const { return !Reference.IsEmpty(); }
+	bool IsActive() const { return IsLogging() || HasReference(); }
+
+	/** Hash Data after step Step, log it and compare it with the reference; false on the first divergence */
+	bool Observe(const mjModel* Model, const mjData* Data, int64 Step);
+
+	/** Step of the first divergence from the reference, or INDEX_NONE */
+	int64 GetFirstDivergentStep() const { return FirstDivergentStep; }
+	int64 GetStepsCompared() const { return StepsCompared; }
+	uint64 GetLastHash() const { return LastHash; }
+
+private:
+	TUniquePtr<FArchive> Archive;
+
+	/** Reference hash by step */
+	TMap<int64, uint64> Reference;
+
+	int64 FirstDivergentStep = INDEX_NONE;
+	int64 StepsCompared = 0;
+	uint64 LastHash = 0;
+};
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MujocoLidarComponent.generated.h"
+
+class AMujocoManager;
+class FMujocoAPI;
+class FMujocoDataPool;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoLidar, Log, All);
+
+
+/**
+ * Range sensor that casts its rays against the MuJoCo collision geometry with mj_multiRay.
+ *
+ * The scan pattern is precomputed in the sensor frame when the sensor is bound to a model.
+ * Scans are run by the owning AMujocoManager after each simulation tick, in parallel across
+ * sensors, and write into buffers that are reused from scan to scan.
+ */
+UCLASS(ClassGroup=(MuJoCo), meta=(BlueprintSpawnableComponent))
+class MUJOCODEMO_API UMujocoLidarComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMujocoLidarComponent();
+
+	/** Latest distances, HorizontalSamples * VerticalSamples values in MuJoCo units; -1 where nothing was hit */
+	TArrayView<const mjtNum> GetDistances() const { return Distances; }
+
+	/** Geom hit by each ray of the latest scan, -1 where nothing was hit */
+	TArrayView<const int32> GetHitGeoms() const { return HitGeoms; }
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Lidar")
+	void CopyDistances(TArray<double>& OutDistances) const;
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Lidar")
+	int32 GetNumRays() const { return HorizontalSamples * VerticalSamples; }
+
+	/** Resolve the attachment frame, build the ray pattern and take a scratch mjData from Pool */
+	bool BindToModel(const FMujocoAPI& Api, const mjModel* Model, FMujocoDataPool& Pool);
+
+	/** Give the scratch mjData back before the model goes away */
+	void Unbind(FMujocoDataPool& Pool);
+
+	bool IsBound() const { return Model != nullptr; }
+
+	/** Cast all rays against the poses in Source. Safe to run concurrently for different sensors. */
+	void Scan(const FMujocoAPI& Api, const mjData* Source);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Manager simulating the world this sensor lives in; defaults to the owning actor */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar")
+	TObjectPtr<AMujocoManager> Manager;
+
+	/** MuJoCo site the sensor is mounted on. The sensor looks along the site's +X axis. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar")
+	FName SiteName;
+
+	/** Used when SiteName is empty: mount the sensor at a body frame instead */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar")
+	FName BodyName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar", meta=(ClampMin="1"))
+	int32 HorizontalSamples = 360;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar", meta=(ClampMin="1"))
+	int32 VerticalSamples = 16;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar", meta=(ClampMin="0.0", ClampMax="360.0"))
+	float HorizontalFov = 360.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar", meta=(ClampMin="0.0", ClampMax="180.0"))
+	float VerticalFov = 30.0f;
+
+	/** Maximum range in MuJoCo units */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar", meta=(ClampMin="0.0"))
+	double MaxRange = 30.0;
+
+	/** Bit i enables geom group i (MuJoCo has 6 groups) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar")
+	uint8 GeomGroupMask = 0x3F;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar")
+	bool bIncludeStatic = true;
+
+	/** Ignore the geoms of the body the sensor is mounted on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Lidar")
+	bool bExcludeMountBody = true;
+
+private:
+	const mjModel* Model = nullptr;
+
+	/** Scratch data holding a copy of the geom poses; mj_multiRay uses its stack */
+	mjData* ScratchData = nullptr;
+
+	int32 SiteId = -1;
+	int32 BodyId = -1;
+	mjtByte GeomGroup[mjNGROUP] = {};
+
+	/** Ray directions in the sensor frame and rotated into the world frame */
+	TArray<mjtNum> LocalDirections;
+	TArray<mjtNum> WorldDirections;
+
+	TArray<mjtNum> Distances;
+	TArray<int32> HitGeoms;
+};
@@ -7,13 +7,56 @@
 
 #include "CoreMinimal.h"
 #include "MujocoAPI.h"
+#include "MujocoContacts.h"
+#include "MujocoControlBuffer.h"
+#include "MujocoConversion.h"
+#include "MujocoDebugDraw.h"
+#include "MujocoDeterminism.h"
+#include "MujocoController.h"
+#include "MujocoDataPool.h"
+#include "MujocoMemoryTelemetry.h"
+#include "MujocoNameIndex.h"
+#include "MujocoPolicyBridge.h"
+#include "MujocoPoseBuffer.h"
+#include "MujocoRayTracer.h"
+#include "MujocoRewindBuffer.h"
+#include "MujocoRolloutPool.h"
+#include "MujocoSceneBuilder.h"
+#include "MujocoSensors.h"
+#include "MujocoSimulationLOD.h"
+#include "MujocoStateStreamer.h"
+#include "MujocoStepClock.h"
+#include "MujocoTrajectory.h"
 #include "GameFramework/Actor.h"
 #include "MujocoManager.generated.h"
 
+class UInstancedStaticMeshComponent;
+class ULineBatchComponent;
+class UMujocoDepthCameraComponent;
+class UMujocoLidarComponent;
+
 
 DECLARE_LOG_CATEGORY_EXTERN(LogMujocoManager, Log, All);
 
 
+/** Geoms drawn as instances of one shared mesh in one color */
+USTRUCT()
+struct FMujocoGeomBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TObjectPtr<UInstancedStaticMeshComponent> Component;
+
+	FLinearColor Color = FLinearColor::White;
+
+	/** Geom drawn by each instance, in instance order */
+	TArray<int32> Geoms;
+
+	/** Instance scale of each geom; only the poses change from frame to frame */
+	TArray<FVector> Scales;
+};
+
 UCLASS()
 class MUJOCODEMO_API AMujocoManager : public AActor
 {
@@ -31,13 +74,61 @@ public:
 	UFUNCTION(BlueprintCallable, Category="MuJoCo")
 	bool LoadModel();
 
-	/** Step the simulation */
+	/** Builder for a scene composed from robot templates; pass it to LoadScene once populated */
+	TUniquePtr<FMujocoSceneBuilder> MakeSceneBuilder() const { return MakeUnique<FMujocoSceneBuilder>(MujocoApi); }
+
+	/** Compile Builder's scene and load it in place of the current model; the manager keeps the spec */
+	bool LoadScene(TUniquePtr<FMujocoSceneBuilder> Builder);
+
+	/**
+	 * Load SceneXMLPath (or an empty world) with one copy of the robot in RobotXMLPath at each of
+	 * Placements, given in Unreal world space. Instances are named robot0_, robot1_, ...
+	 */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Scene")
+	bool SpawnRobots(const FString& SceneXMLPath, const FString& RobotXMLPath, const TArray<FTransform>& Placements);
+
+	/** Robots of the scene loaded by LoadScene or SpawnRobots, in the order they were added */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Scene")
+	TArray<FMujocoRobotInstance> GetRobotInstances() const;
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Scene")
+	void ReadRobotState(const FMujocoRobotInstance& Robot, TArray<double>& OutQpos, TArray<double>& OutQvel) const;
+
+	/** Stage controls for Robot's actuators, in actuator order */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Scene")
+	void SetRobotControls(const FMujocoRobotInstance& Robot, const TArray<double>& Values);
+
+	/**
+	 * Add a box body under the world at Transform (Unreal space) and apply the edit at once,
+	 * keeping the state of everything else. Returns the new body, or an invalid handle on failure.
+	 */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Scene")
+	FMujocoBodyHandle AddBox(FName Name, const FTransform& Transform, FVector HalfExtents, double Mass = 1.0, bool bFreeJoint = true);
+
+	/** Delete a body, its subtree and everything referencing it, and apply the edit at once */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Scene")
+	bool RemoveBody(FName Name);
+
+	/** Live spec of the loaded scene for batched edits; follow them with ApplySceneEdit */
+	FMujocoSceneBuilder* GetSceneBuilder() const { return SceneBuilder.Get(); }
+
+	/**
+	 * Recompile the edited spec in place, carrying the simulation state over, then rebind
+	 * everything model-dependent and add or drop only the mesh components of changed geoms.
+	 */
+	bool ApplySceneEdit();
+
+	/** Robot's slice of qpos and qvel; valid until the next step or model change */
+	TArrayView<const double> GetRobotQpos(const FMujocoRobotInstance& Robot) const { return MjData ? TArrayView<const double>(MjData->qpos + Robot.FirstQpos, Robot.NumQpos) : TArrayView<const double>(); }
+	TArrayView<const double> GetRobotQvel(const FMujocoRobotInstance& Robot) const { return MjData ? TArrayView<const double>(MjData->qvel + Robot.FirstDof, Robot.NumDofs) : TArrayView<const double>(); }
+
+	/** Step the simulation; false if no step was taken, e.g. without a model or after divergence */
 	UFUNCTION(BlueprintCallable, Category="MuJoCo")
-	void StepSimulation();
+	bool StepSimulation();
 
 	/** Reset the simulation */
 	UFUNCTION(BlueprintCallable, Category="MuJoCo")
-	void ResetSimulation() const;
+	void ResetSimulation();
 
 	UFUNCTION(BlueprintCallable, Category="MuJoCo")
 	void PrintBodyPosition() const;
@@ -45,6 +136,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category="MuJoCo")
 	void SpawnMuJoCoObjects(); // Creates Unreal objects from the model
 
+	/** Draw geom ModelNum as an instance of Mesh scaled by Size, batched with other geoms of the same mesh and color */
 	UFUNCTION(BlueprintCallable, Category="MuJoCo")
 	void HandleStaticMeshObject(const int ModelNum, const FVector& Position, const FVector& Size, const FQuat& Rotation, UStaticMesh* Mesh);
 
@@ -54,6 +146,193 @@ public:
 	UFUNCTION(BlueprintCallable, Category="MuJoCo")
 	void UpdateMuJoCoObjects(); // Syncs objects with simulation
 
+	/** Record one state frame per physics step to a trajectory file; a reset or rewind ends the recording */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Replay")
+	bool StartRecording(const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Replay")
+	void StopRecording();
+
+	/** Hash qpos, qvel and act after every physics step and write the hashes to a stream file */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Determinism")
+	bool StartHashLog(const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Determinism")
+	void StopHashLog();
+
+	/** Compare the hash after every physics step against a stream written by StartHashLog */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Determinism")
+	bool StartDeterminismCheck(const FString& ReferencePath);
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Determinism")
+	void StopDeterminismCheck();
+
+	/** First step whose state differed from the reference stream, or -1 while all match */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Determinism")
+	int64 GetFirstDivergentStep() const { return Determinism.GetFirstDivergentStep(); }
+
+	/** Hash of the state after the last step, while hashing is on */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Determinism")
+	int64 GetLastStateHash() const { return static_cast<int64>(Determinism.GetLastHash()); }
+
+	/** Play a recorded trajectory back through kinematics only; physics is not stepped while replaying */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Replay")
+	bool StartReplay(const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Replay")
+	void StopReplay();
+
+	/** Jump the replay to the frame nearest to Time (simulation seconds) and update the scene */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Replay")
+	void SeekReplay(double Time);
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Replay")
+	bool IsReplaying() const { return TrajectoryReader.IsOpen(); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Replay")
+	double GetReplayTime() const { return ReplayTime; }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Replay")
+	double GetReplayStartTime() const { return TrajectoryReader.GetStartTime(); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Replay")
+	double GetReplayEndTime() const { return TrajectoryReader.GetEndTime(); }
+
+	/** Preallocate buffers for NumRollouts parallel rollouts of the loaded model */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Rollout")
+	bool InitializeRollouts(int32 NumRollouts);
+
+	/**
+	 * Simulate every candidate control sequence for Horizon steps from the current state.
+	 * Controls are laid out [Rollout][Step][Actuator]. Results are read back from GetRolloutPool().
+	 */
+	bool EvaluateRollouts(TArrayView<const double> Controls, int32 Horizon, FMujocoRolloutCost Cost);
+
+	const FMujocoRolloutPool& GetRolloutPool() const { return RolloutPool; }
+
+	/** Restore the state recorded for simulation step Step and resume from there */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Rewind")
+	bool RewindToStep(int64 Step);
+
+	/** Step back Seconds of simulated time, clamped to the rewind window */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Rewind")
+	bool RewindSeconds(double Seconds);
+
+	/** Number of physics steps taken since the model was loaded or reset */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Rewind")
+	int64 GetSimulationStep() const { return SimulationStep; }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Rewind")
+	void GetRewindWindow(int64& OldestStep, int64& NewestStep) const;
+
+	/** Fraction of mjData requests served from the pool without allocating */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Memory")
+	double GetDataPoolHitRate() const { return DataPool->GetHitRate(); }
+
+	const std::shared_ptr<FMujocoDataPool>& GetDataPool() const { return DataPool; }
+
+	/** Peak arena, stack, contact and constraint usage since the model was loaded */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Memory")
+	FMujocoMemoryStats GetMemoryStats() const { return MemoryTelemetry.GetStats(); }
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Memory")
+	void LogMemoryStats() const;
+
+	/** Achieved realtime factor, steps per second and time dropped to the step cap */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Stepping")
+	FMujocoStepClockStats GetSteppingStats() const { return StepClock.GetStats(); }
+
+	/** Reallocate MjData with an arena of ArenaBytes, keeping the simulation state */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Memory")
+	bool ResizeArena(int64 ArenaBytes);
+
+	/** Resize the arena to the observed peak plus ArenaHeadroom, but never below the compiled size */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Memory")
+	bool RightSizeArena();
+
+	/** Stage controls for actuators FirstActuator onwards; they take effect at the start of the next step */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Control")
+	void SetControls(const TArray<double>& Values, int32 FirstActuator = 0) { ControlBuffer.SetControls(Values, FirstActuator); }
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Control")
+	void SetControl(const FMujocoActuatorHandle& Actuator, double Value) { ControlBuffer.SetControl(Actuator.Id, Value); }
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Control")
+	void GetStagedControls(TArray<double>& OutValues) const { ControlBuffer.GetStagedControls(OutValues); }
+
+	/** Thread-safe entry point for native control sources */
+	FMujocoControlBuffer& GetControlBuffer() { return ControlBuffer; }
+
+	/** Run Controller before every physics step, in registration order; binds it to the current model if one is loaded */
+	void RegisterController(const TSharedRef<IMujocoController>& Controller);
+	void UnregisterController(const TSharedRef<IMujocoController>& Controller);
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Names")
+	FMujocoBodyHandle FindBody(FName Name) const { return NameIndex.FindBody(Name); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Names")
+	FMujocoJointHandle FindJoint(FName Name) const { return NameIndex.FindJoint(Name); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Names")
+	FMujocoActuatorHandle FindActuator(FName Name) const { return NameIndex.FindActuator(Name); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Names")
+	FMujocoSiteHandle FindSite(FName Name) const { return NameIndex.FindSite(Name); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Names")
+	FMujocoGeomHandle FindGeom(FName Name) const { return NameIndex.FindGeom(Name); }
+
+	/** Name lookup for any object type; same result as mj_name2id in constant time */
+	const FMujocoNameIndex& GetNameIndex() const { return NameIndex; }
+
+	/** Resolve a sensor by name; cache the handle rather than looking it up every frame */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Sensors")
+	FMujocoSensorHandle FindSensor(FName Name) const { return SensorTable.Find(Name); }
+
+	/** Resolve a set of sensors once for repeated ReadSensors calls */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Sensors")
+	FMujocoSensorBatch ResolveSensors(const TArray<FName>& Names) const;
+
+	/** Copy the current values of every sensor in Batch into OutValues, in batch order */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Sensors")
+	void ReadSensors(const FMujocoSensorBatch& Batch, TArray<double>& OutValues) const;
+
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Sensors")
+	void ReadSensor(const FMujocoSensorHandle& Sensor, TArray<double>& OutValues) const;
+
+	/** Read-only view of a sensor's current values; valid until the next step, empty once the model changes */
+	TArrayView<const double> GetSensorView(const FMujocoSensorHandle& Sensor) const { return SensorTable.View(MjData, Sensor); }
+
+	/** All of sensordata */
+	TArrayView<const double> GetSensorData() const { return MjData && MjModel ? TArrayView<const double>(MjData->sensordata, MjModel->nsensordata) : TArrayView<const double>(); }
+
+	const FMujocoSensorTable& GetSensorTable() const { return SensorTable; }
+
+	/** Contacts of the latest step; requires bExtractContacts */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Contacts")
+	void GetContacts(TArray<FMujocoContact>& OutContacts) const;
+
+	/** Total normal force on Body over its contacts in the latest step */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Contacts")
+	double GetBodyNormalForce(const FMujocoBodyHandle& Body) const { return ContactQuery.GetBodyNormalForce(Body.Id); }
+
+	/** Aggregate contacts between BodyA and BodyB (or BodyA and anything if BodyB is invalid) on every step */
+	UFUNCTION(BlueprintCallable, Category="MuJoCo|Contacts")
+	int32 AddContactPairFilter(const FMujocoBodyHandle& BodyA, const FMujocoBodyHandle& BodyB) { return ContactQuery.AddPairFilter(BodyA.Id, BodyB.Id); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Contacts")
+	FMujocoContactPairStats GetContactPairStats(int32 Filter) const;
+
+	const FMujocoContactQuery& GetContactQuery() const { return ContactQuery; }
+
+	/** Scan Lidar after every simulation tick; binds it to the current model if one is loaded */
+	void RegisterLidar(UMujocoLidarComponent* Lidar);
+	void UnregisterLidar(UMujocoLidarComponent* Lidar);
+
+	/** Render Camera after every simulation tick; binds it to the current model if one is loaded */
+	void RegisterDepthCamera(UMujocoDepthCameraComponent* Camera);
+	void UnregisterDepthCamera(UMujocoDepthCameraComponent* Camera);
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -61,6 +340,31 @@ public:
 	virtual void Tick(float DeltaTime) override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	/** Frees the model of a manager destroyed without having begun play, which gets no EndPlay */
+	virtual void Destroyed() override;
+
+	/**
+	 * Physics half of a frame: take the steps owed for DeltaTime. Touches only this manager's
+	 * MuJoCo state, so UMujocoWorldSubsystem runs it for several managers at once.
+	 */
+	void AdvanceSimulation(float DeltaTime);
+
+	/** Game-thread half of a frame: arena resizes, replay, sensors, mesh components and debug drawing */
+	void SyncToScene(float DeltaTime);
+
+	/** Pick the simulation LOD from the viewer at ViewLocation; freezes or resumes the model as needed */
+	void UpdateSimulationLOD(const FVector& ViewLocation);
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|LOD")
+	EMujocoSimulationLOD GetSimulationLOD() const { return SimulationLOD.GetLevel(); }
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|LOD")
+	bool IsSimulationFrozen() const { return SimulationLOD.IsFrozen(); }
+
+	/** Steps per second the current LOD skips compared to the full rate */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|LOD")
+	double GetLODStepsSavedPerSecond() const { return LODStepsSavedPerSecond; }
+
 protected:
 	/** Path to the MuJoCo XML model */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo")
@@ -78,17 +382,160 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo")
 	float InputControl = 0.0f;
 
+	/** Actuator driven by InputControl; the first actuator when empty. Resolved on model load. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo")
-	double TransformScale = 1.0;
+	FName ControlActuatorName;
 
+	/** Body logged by PrintBodyPosition; the first movable body when empty. Resolved on model load. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo")
-	double PositionScale = 1.0;
+	FName TrackedBodyName;
 
+	/** Units and axes between the model and the level, for positions, rotations, sizes and mesh vertices alike */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo")
-	double SizeScale = 1.0;
+	FMujocoConversion Conversion;
+
+	/** How simulated time advances relative to wall-clock time while bStepSimulation is on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Stepping")
+	EMujocoStepMode StepMode = EMujocoStepMode::RealTime;
+
+	/** Simulated seconds per wall-clock second in Scaled mode */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Stepping", meta=(ClampMin="0.0", EditCondition="StepMode == EMujocoStepMode::Scaled"))
+	double TimeScale = 1.0;
+
+	/**
+	 * Most physics steps taken in one frame. Time owed beyond that is dropped rather than
+	 * carried, so a simulation that cannot keep up slows down instead of stalling the game.
+	 * AsFastAsPossible ignores it and is bounded by FrameBudgetMilliseconds alone.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Stepping", meta=(ClampMin="1"))
+	int32 MaxStepsPerFrame = 64;
+
+	/**
+	 * Step together with the world's other managers on the task graph instead of in this
+	 * actor's tick. Takes effect on BeginPlay.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Stepping")
+	bool bStepOnWorldSubsystem = true;
+
+	/** Wall-clock time per frame spent stepping in AsFastAsPossible mode, scaled down by simulation LOD */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Stepping", meta=(ClampMin="0.0", EditCondition="StepMode == EMujocoStepMode::AsFastAsPossible"))
+	double FrameBudgetMilliseconds = 16.0;
+
+	/**
+	 * Render geoms blended between the last two physics steps by the time left over in the
+	 * current step instead of at the latest step. Smooths motion when the frame rate and the
+	 * physics rate differ, at the cost of showing the scene one step behind.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Rendering")
+	bool bInterpolatePoses = false;
+
+	/** Step rate and scene sync by distance from the viewer */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD")
+	FMujocoLODSettings LODSettings;
+
+	/** Simulated seconds over which newly staged controls are blended in; 0 applies them on the next step */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Control", meta=(ClampMin="0.0"))
+	double ControlInterpolationTime = 0.0;
+
+	/**
+	 * Before every step, publish [time, qpos, qvel] to an external policy through shared memory
+	 * and stage the nu actions it answers with. Applied on model load.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Policy")
+	bool bEnablePolicyBridge = false;
+
+	/** Shared memory segment name the policy process opens */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Policy")
+	FString PolicyBridgeName = TEXT("mujoco_policy");
+
+	/** How long a step waits for the policy before keeping the previous controls */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Policy", meta=(ClampMin="0.0"))
+	double PolicyTimeoutMilliseconds = 5.0;
+
+	/** Stream time, qpos, StreamedSensors and the contact count to local TCP subscribers after every step */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Streaming")
+	bool bEnableStateStream = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Streaming", meta=(ClampMin="1", ClampMax="65535"))
+	int32 StreamPort = 27182;
+
+	/** Accept connections from other machines, not just this one */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Streaming")
+	bool bStreamAllowRemote = false;
+
+	/** Frames per second sent to a client that has not asked for a rate; 0 sends every step */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Streaming", meta=(ClampMin="0.0"))
+	double StreamMaxRateHz = 60.0;
+
+	/** Frames buffered per client before the oldest is dropped */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Streaming", meta=(ClampMin="1"))
+	int32 StreamQueueDepth = 8;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Streaming")
+	TArray<FName> StreamedSensors;
+
+	/** Pull contacts, forces and per-body totals out of mjData after every step */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Contacts")
+	bool bExtractContacts = false;
+
+	/** Draw contacts, contact forces, centers of mass and joint axes in the viewport */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Debug")
+	bool bDebugDraw = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Debug", meta=(EditCondition="bDebugDraw"))
+	bool bDebugDrawContacts = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Debug", meta=(EditCondition="bDebugDraw"))
+	bool bDebugDrawContactForces = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Debug", meta=(EditCondition="bDebugDraw"))
+	bool bDebugDrawCentersOfMass = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Debug", meta=(EditCondition="bDebugDraw"))
+	bool bDebugDrawJointAxes = false;
+
+	/** Arrow length in Unreal units per Newton of contact force */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Debug", meta=(EditCondition="bDebugDraw", ClampMin="0.0"))
+	double DebugForceScale = 1.0;
+
+	/** Most lines drawn per frame; dense scenes are subsampled to stay interactive */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Debug", meta=(EditCondition="bDebugDraw", ClampMin="1"))
+	int32 DebugMaxLines = 20000;
+
+	/** Replay rate relative to real time; negative values play backwards */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Replay")
+	double ReplaySpeed = 1.0;
+
+	/** Wrap around at either end of the recording instead of stopping there */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Replay")
+	bool bLoopReplay = false;
+
+	/** Keep a history of recent states that RewindToStep can return to. Applied on model load. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Rewind")
+	bool bEnableRewind = false;
+
+	/** Memory budget of the rewind history; older steps are dropped once it is full */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Rewind", meta=(ClampMin="1"))
+	int32 RewindBudgetMegabytes = 64;
+
+	/** Steps between full keyframes; bounds the cost of a rewind */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Rewind", meta=(ClampMin="1"))
+	int32 RewindKeyframeInterval = 120;
+
+	/**
+	 * Right-size the arena once ArenaTuneAfterSteps steps have been observed, and grow it on
+	 * overflow. Resizes are applied on the game thread after the frame's steps.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Memory")
+	bool bAutoTuneArena = false;
+
+	/** Extra arena kept above the observed peak, as a fraction of the peak */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Memory", meta=(ClampMin="0.0"))
+	double ArenaHeadroom = 0.25;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|Memory", meta=(ClampMin="1"))
+	int32 ArenaTuneAfterSteps = 2000;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo")
-	double VertexScale = 1000.0;
 	/** MuJoCo Model */
 	mjModel* MjModel;
 
@@ -98,13 +545,129 @@ protected:
 	// MujocoAPI that makes sure the library is loaded through Unreal
 	std::shared_ptr<FMujocoAPI> MujocoApi;
 
+	// Recycles mjData instances for loads, resets and rollouts
+	std::shared_ptr<FMujocoDataPool> DataPool;
+
+	// Spec the loaded model was compiled from, kept for runtime edits
+	TUniquePtr<FMujocoSceneBuilder> SceneBuilder;
+
 private:
+	/** Take ownership of a freshly compiled Model: allocate data and bind everything model-dependent */
+	bool InitializeModel(mjModel* Model);
+
+	/** Size every model-dependent buffer, index and binding for the current model */
+	void BindModel();
+
+	/**
+	 * Undo BindModel; MjModel and MjData stay. bKeepSettings leaves the controllers bound, so a
+	 * rebind after a scene edit keeps their gains and targets.
+	 */
+	void UnbindModel(bool bKeepSettings = false);
+
+	/** Return MjData to the pool and free MjModel */
+	void UnloadModel();
+
+	/** Add one geom to the scene: an instance of a shared primitive mesh, or a component of its own for mesh geoms */
+	void SpawnGeom(int Geom);
+
+	/** Unregister and forget every component and instance made by SpawnMuJoCoObjects */
+	void DestroySpawnedMeshes();
+	void DestroySpawnedMesh(UMeshComponent* Mesh);
+
+	/** Move components and instances to their geoms' new ids after a recompile, dropping removed geoms and spawning new ones */
+	void PatchSpawnedMeshes(TConstArrayView<int32> GeomRemap);
+
+	/** Copy geom poses from MjData onto the spawned mesh components */
+	void ApplyGeomPosesToMeshes();
+
+	/** Place the spawned mesh components at the blended poses of PoseBuffer */
+	void ApplyInterpolatedPosesToMeshes();
+
+	/** Send the current state to the external policy and stage its actions */
+	void ExchangeWithPolicy();
+
+	/** Rebuild and submit the debug lines, or clear them when debug drawing is off */
+	void UpdateDebugDraw();
+
+	/** Run all registered lidar scans in parallel against the current poses */
+	void ScanLidarSensors();
+
+	/** Snapshot the scene into the ray tracer and render every registered depth camera */
+	void RenderDepthCameras();
+
+	/** Whether steps capture poses for blending: always at Mid, which steps slower than frames */
+	bool ShouldInterpolatePoses() const { return bInterpolatePoses || SimulationLOD.GetLevel() == EMujocoSimulationLOD::Mid; }
+
+	/** Load a replay frame, run kinematics and sync the scene */
+	void ApplyReplayFrame(int64 FrameIndex);
+
 	bool bLogStateChange = true;
 
-	float AccumulatedTime = 0.0f;  // Keeps track of accumulated time
-	const float FixedTimeStep = 1.0f / 60.0f;  // MuJoCo step time (60 Hz)
+	FMujocoTrajectoryWriter TrajectoryWriter;
+	FMujocoDeterminismChecker Determinism;
+	FMujocoTrajectoryReader TrajectoryReader;
+	FMujocoRolloutPool RolloutPool;
+	FMujocoRewindBuffer RewindBuffer;
+	FMujocoMemoryTelemetry MemoryTelemetry;
+	FMujocoRayTracer RayTracer;
+	FMujocoNameIndex NameIndex;
+	FMujocoControlBuffer ControlBuffer;
+	FMujocoContactQuery ContactQuery;
+	FMujocoDebugDraw DebugDraw;
+	FMujocoPoseBuffer PoseBuffer;
+	FMujocoPolicyBridge PolicyBridge;
+	FMujocoStateStreamer StateStreamer;
+	FMujocoSensorBatch StreamedSensorBatch;
+	bool bPolicyResponding = true;
+
+	/** Registered controllers and whether each is bound to the current model */
+	TArray<TSharedRef<IMujocoController>> Controllers;
+	TBitArray<> BoundControllers;
+	FMujocoSensorTable SensorTable;
+	FMujocoActuatorHandle ControlActuator;
+	FMujocoBodyHandle TrackedBody;
+	bool bArenaTuned = false;
+
+	// Arena size chosen by the auto-tune during stepping, applied on the game thread by SyncToScene
+	int64 PendingArenaBytes = 0;
+	int64 SimulationStep = 0;
+	double ReplayTime = 0.0;
+	int64 ReplayFrame = INDEX_NONE;
+
+	// Turns frame time into steps of the model's opt.timestep
+	FMujocoStepClock StepClock;
+
+	// Steps taken by the last AdvanceSimulation, for SyncToScene
+	int32 StepsTakenThisFrame = 0;
+
+	// Set while UMujocoWorldSubsystem ticks this manager
+	bool bSteppedBySubsystem = false;
+
+	FMujocoSimulationLOD SimulationLOD;
+	double LODStepsSavedPerSecond = 0.0;
 
 	// Store objects in map from unreal <-> mujoco
 	UPROPERTY()
 	TMap<int32, UMeshComponent*> SpawnedMeshes;
+
+	/** Primitive and heightfield geoms, one instanced component per shared mesh and color */
+	UPROPERTY(Transient)
+	TArray<FMujocoGeomBatch> GeomBatches;
+
+	/** Meshes of the current model's heightfields by hfield id */
+	UPROPERTY(Transient)
+	TMap<int32, TObjectPtr<UStaticMesh>> HeightfieldMeshes;
+
+	/** Scratch for the per-batch instance updates */
+	TArray<FTransform> InstanceTransforms;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMujocoLidarComponent>> LidarSensors;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMujocoDepthCameraComponent>> DepthCameras;
+
+	/** Created the first time debug drawing is enabled */
+	UPROPERTY(Transient)
+	TObjectPtr<ULineBatchComponent> DebugLineBatcher;
 };
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "MujocoMemoryTelemetry.generated.h"
+
+
+/** Peak mjData memory usage observed over a run */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoMemoryStats
+{
+	GENERATED_BODY()
+
+	/** Arena size currently allocated per mjData (model 'memory' attribute) */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Memory")
+	int64 ArenaBytes = 0;
+
+	/** Highest combined arena and stack usage (maxuse_arena) */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Memory")
+	int64 PeakArenaBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Memory")
+	int64 PeakStackBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Memory")
+	int32 PeakContacts = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Memory")
+	int32 PeakConstraints = 0;
+
+	/** Steps on which the contact list or constraint rows ran out of arena */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Memory")
+	int32 Overflows = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Memory")
+	int64 StepsObserved = 0;
+};
+
+/**
+ * Accumulates the high-water marks MuJoCo keeps in mjData. MuJoCo clears them on every
+ * mj_resetData, so they are folded into run-wide peaks after each step.
+ */
+class MUJOCODEMO_API FMujocoMemoryTelemetry
+{
+public:
+	/** Start a new run for data allocated with Model's current arena size */
+	void Reset(const mjModel* Model);
+
+	/** Track a new arena size; the peaks are kept since they describe the workload, not the allocation */
+	void OnArenaResized(const mjModel* Model);
+
+	/** Fold the current high-water marks of Data into the run peaks */
+	void Observe(const mjData* Data);
+
+	/** True if the last observed step ran out of arena for contacts or constraints */
+	bool HadOverflow() const { return bLastStepOverflowed; }
+
+	const FMujocoMemoryStats& GetStats() const { return Stats; }
+
+	/**
+	 * Arena size that covers the observed peak plus Headroom (fraction of the peak), page aligned.
+	 * Never less than the arena the run started with: a later step can need more than any step
+	 * so far, and only contact and constraint overflows are recoverable; running out of stack
+	 * is a MuJoCo error.
+	 */
+	int64 GetRecommendedArenaBytes(double Headroom) const;
+
+private:
+	FMujocoMemoryStats Stats;
+
+	/** Arena size passed to Reset, which right-sizing only grows from */
+	int64 InitialArenaBytes = 0;
+	int32 LastOverflowCount = 0;
+	bool bLastStepOverflowed = false;
+};
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+
+#include "CoreMinimal.h"
+#include "MujocoNameIndex.generated.h"
+
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoNames, Log, All);
+
+
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoBodyHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Names")
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoJointHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Names")
+	int32 Id = INDEX_NONE;
+
+	/** Offset of the joint's coordinates in qpos (jnt_qposadr) */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Names")
+	int32 QposAddress = 0;
+
+	/** Offset of the joint's degrees of freedom in qvel (jnt_dofadr) */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Names")
+	int32 DofAddress = 0;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoActuatorHandle
+{
+	GENERATED_BODY()
+
+	/** Index into ctrl */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Names")
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoSiteHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Names")
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoGeomHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Names")
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+/**
+ * Constant-time replacement for mj_name2id, built once per model.
+ *
+ * Every named object type gets a perfect hash (hash-and-displace): keys are split
+ * into small buckets, and each bucket stores the seed that sends all of its keys to free
+ * slots. A lookup is two hashes, one slot read and one string compare against the model's
+ * own name buffer, so unknown names are rejected without any probing.
+ *
+ * MuJoCo names are case-sensitive and so are the string lookups. FName is not: names that
+ * differ only in case share one FName, which cannot say which object is meant. Build reports
+ * such names, and the FName lookups refuse them; use the string overloads for those.
+ */
+class MUJOCODEMO_API FMujocoNameIndex
+{
+public:
+	void Build(const mjModel* Model);
+	void Reset();
+
+	bool IsBuilt() const { return Model != nullptr; }
+
+	/** Same result as mj_name2id: the object id, or -1 if there is no object of Type called Name */
+	int32 FindId(mjtObj Type, FAnsiStringView Name) const;
+	int32 FindId(mjtObj Type, const FString& Name) const;
+
+	/** As above, but -1 for names another object of Type repeats in a different case */
+	int32 FindId(mjtObj Type, FName Name) const;
+
+	FMujocoBodyHandle FindBody(FName Name) const;
+	FMujocoJointHandle FindJoint(FName Name) const;
+	FMujocoActuatorHandle FindActuator(FName Name) const;
+	FMujocoSiteHandle FindSite(FName Name) const;
+	FMujocoGeomHandle FindGeom(FName Name) const;
+
+	/** Name-address array and object count for Type, or nullptr for types without names */
+	static const int* GetNameAddresses(const mjModel* Model, mjtObj Type, int32& OutCount);
+
+private:
+	struct FTable
+	{
+		/** Per-bucket hash seed */
+		TArray<uint32> Seeds;
+
+		/** Object id per slot, INDEX_NONE for free slots */
+		TArray<int32> Slots;
+
+		/** Set for objects whose name differs from another's only in case */
+		TBitArray<> CaseCollisions;
+	};
+
+	void BuildTable(FTable& Table, const int* NameAddresses, int32 Count) const;
+
+	const mjModel* Model = nullptr;
+	FTable Tables[mjNOBJECT];
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+
+/**
+ * Geom poses of the last two physics steps, for rendering between them.
+ *
+ * Physics runs on a fixed timestep while frames land anywhere in between, so showing the
+ * latest step makes motion judder whenever the display rate is not a multiple of the physics
+ * rate. Blending the previous and current step by the fraction of a step that has elapsed
+ * renders one step behind but moves smoothly, which lets physics run at a cheaper rate.
+ *
+ * Poses are kept in MuJoCo units as structure-of-arrays streams so Blend is a single
+ * branch-free loop the compiler vectorizes.
+ */
+class MUJOCODEMO_API FMujocoPoseBuffer
+{
+public:
+	/** Size the buffers for Model's geoms and fill both frames from Data, so the first blend is a no-op */
+	void Initialize(const mjModel* Model, const mjData* Data, int64 Step);
+	void Release();
+
+	bool IsInitialized() const { return NumGeoms > 0; }
+
+	/** Step the current frame was captured at */
+	int64 GetCurrentStep() const { return CurrentStep; }
+
+	/** Make the current frame the previous one and capture Data as the new current frame */
+	void Capture(const mjData* Data, int64 Step);
+
+	/** Overwrite both frames with Data; use after a reset, rewind or any other jump in state */
+	void Reset(const mjData* Data, int64 Step);
+
+	/** Blend previous and current by Alpha in [0, 1] into the output streams */
+	void Blend(double Alpha);
+
+	/** Blended pose of Geom from the last Blend, in MuJoCo units */
+	FVector GetPosition(const int32 Geom) const { return FVector(Blended.PX[Geom], Blended.PY[Geom], Blended.PZ[Geom]); }
+	FQuat GetRotation(const int32 Geom) const { return FQuat(Blended.QX[Geom], Blended.QY[Geom], Blended.QZ[Geom], Blended.QW[Geom]); }
+
+private:
+	struct FFrame
+	{
+		TArray<double> PX, PY, PZ;
+		TArray<double> QW, QX, QY, QZ;
+
+		void SetNum(int32 Num);
+		void Empty();
+	};
+
+	void Fill(FFrame& Frame, const mjData* Data) const;
+
+	FFrame Frames[2];
+	FFrame Blended;
+	int32 Current = 0;
+	int32 NumGeoms = 0;
+	int64 CurrentStep = INDEX_NONE;
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "MujocoPrimitiveMeshSubsystem.generated.h"
+
+struct FMujocoConversion;
+class UStaticMesh;
+
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoMeshes, Log, All);
+
+
+/**
+ * Procedurally generated unit meshes for MuJoCo's primitive geoms, built once and shared by
+ * every manager.
+ *
+ * Each mesh sits in the geom's local frame at unit size, so geoms of a type share it through
+ * instancing and get their size from the instance scale alone. Boxes and planes have half-extent
+ * 1, spheres radius 1 (ellipsoids scale the sphere), cylinders radius and half-height 1.
+ * Stretching a capsule would flatten its end caps, so capsules get a radius-1 mesh per ratio of
+ * half-length to radius, rounded to CapsuleAspectStep, and an almost uniform scale.
+ *
+ * Heightfields are model data rather than a unit shape; CreateHeightfield builds one per hfield
+ * for the manager to instance.
+ */
+UCLASS()
+class MUJOCODEMO_API UMujocoPrimitiveMeshSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Half-length to radius ratios of capsules sharing a mesh differ by less than this */
+	static constexpr double CapsuleAspectStep = 0.05;
+
+	/** Unreal units drawn either side of a plane whose MuJoCo size is 0, i.e. infinite */
+	static constexpr double InfinitePlaneHalfExtent = 100000.0;
+
+	/**
+	 * Shared mesh for a geom of Type and the instance scale that gives it HalfSize, its
+	 * geom_size converted to Unreal units. Returns null for types without a unit mesh.
+	 */
+	UStaticMesh* FindOrCreate(mjtGeom Type, const FVector& HalfSize, FVector& OutScale);
+
+	/**
+	 * Mesh of heightfield Hfield in the model, at its full size in Unreal units and in the geom
+	 * frame's axes under Conversion, for instancing at unit scale.
+	 */
+	static UStaticMesh* CreateHeightfield(const mjModel* Model, int32 Hfield, const FMujocoConversion& Conversion, UObject* Outer);
+
+	/** Meshes generated so far, capsule variants included */
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Rendering")
+	int32 GetNumMeshes() const { return Meshes.Num(); }
+
+	virtual void Deinitialize() override;
+
+private:
+	/** Unit meshes by geom type in the low byte and capsule aspect step above it */
+	UPROPERTY(Transient)
+	TMap<uint32, TObjectPtr<UStaticMesh>> Meshes;
+};
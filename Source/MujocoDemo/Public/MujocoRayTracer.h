@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <memory>
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+class FMujocoAPI;
+
+/**
+ * Bounding volume hierarchy over the triangles of one MuJoCo mesh, in the geom frame.
+ */
+class MUJOCODEMO_API FMujocoMeshBVH
+{
+public:
+	void Build(const mjModel* Model, int32 MeshId);
+
+	/** Nearest hit distance along Direction (not necessarily unit), or -1 if nothing closer than MaxDistance */
+	double Intersect(const double Origin[3], const double Direction[3], double MaxDistance) const;
+
+private:
+	struct FNode
+	{
+		FVector3f Min;
+		int32 FirstOrRight;	// first triangle for leaves, right child otherwise (the left child is the next node)
+		FVector3f Max;
+		int32 Count;		// number of triangles for leaves, 0 otherwise
+	};
+
+	struct FBuildTriangle
+	{
+		FVector3f Centroid;
+		FIntVector3 Indices;
+	};
+
+	int32 BuildRecursive(TArray<FBuildTriangle>& BuildTriangles, int32 First, int32 Count);
+
+	const float* Vertices = nullptr;
+	TArray<FIntVector3> Triangles;
+	TArray<FNode> Nodes;
+};
+
+/**
+ * CPU ray caster over the MuJoCo scene for sensors that need many rays per frame.
+ *
+ * Prepare() snapshots the bounding spheres of all visible geoms into flat arrays once per
+ * frame; each ray first culls against those arrays in a tight, vectorizable loop and only
+ * runs exact intersection (mju_rayGeom for primitives, a per-mesh BVH for meshes) on the
+ * few geoms whose bounding sphere it crosses. Trace() is safe to call from many threads
+ * after Prepare().
+ */
+class MUJOCODEMO_API FMujocoRayTracer
+{
+public:
+	/** Build the per-mesh BVHs for Model. Called once per model. */
+	void BindToModel(const std::shared_ptr<FMujocoAPI>& InApi, const mjModel* InModel);
+	void Unbind();
+
+	bool IsBound() const { return Model != nullptr; }
+
+	/** Snapshot geom poses from Data. Must be called before tracing against a new state. */
+	void Prepare(const mjData* Data);
+
+	/**
+	 * Distance to the nearest geom along a unit Direction, or -1 if nothing is hit within MaxDistance.
+	 * @param GroupMask Bit i enables geom group i
+	 */
+	double Trace(const double Origin[3], const double Direction[3], double MaxDistance, uint8 GroupMask) const;
+
+private:
+	std::shared_ptr<FMujocoAPI> Api;
+	const mjModel* Model = nullptr;
+	const mjData* Data = nullptr;
+
+	/** BVH per mesh id, only for meshes referenced by a geom */
+	TArray<TUniquePtr<FMujocoMeshBVH>> MeshBVHs;
+
+	/** Bounding spheres of the bounded geoms, structure-of-arrays for the culling loop */
+	TArray<double> CenterX;
+	TArray<double> CenterY;
+	TArray<double> CenterZ;
+	TArray<double> RadiusSquared;
+	TArray<uint8> GroupBits;
+	TArray<int32> BoundedGeoms;
+
+	/** Planes are unbounded and always tested exactly */
+	TArray<int32> PlaneGeoms;
+	TArray<uint8> PlaneGroupBits;
+};
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "Containers/RingBuffer.h"
+
+class FMujocoAPI;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoRewind, Log, All);
+
+/**
+ * Fixed-budget history of the full simulation state, one entry per physics step.
+ *
+ * Every KeyframeInterval steps a complete state is stored; the steps in between only store
+ * the values that differ from that keyframe. Restoring any step therefore decodes at most
+ * one keyframe and one delta, regardless of how long the history is. When the budget is
+ * exhausted the oldest keyframe is dropped together with its deltas.
+ */
+class MUJOCODEMO_API FMujocoRewindBuffer
+{
+public:
+	/** Full integration state so that resuming after a rewind is bit-identical */
+	static constexpr uint32 StateSpec = mjSTATE_INTEGRATION;
+
+	bool Initialize(const FMujocoAPI& Api, const mjModel* Model, int64 MemoryBudgetBytes, int32 InKeyframeInterval);
+	void Release();
+
+	/** Drop the recorded history but keep the storage */
+	void Clear();
+
+	/** Record the state of Data as simulation step Step. Steps must be consecutive. */
+	void Capture(const FMujocoAPI& Api, const mjModel* Model, const mjData* Data, int64 Step);
+
+	/** Write the state recorded for Step into Data and discard everything after it */
+	bool Restore(int64 Step, const FMujocoAPI& Api, const mjModel* Model, mjData* Data);
+
+	bool IsInitialized() const { return StateSize > 0; }
+	bool IsEmpty() const { return Entries.IsEmpty(); }
+	int64 GetOldestStep() const { return Entries.IsEmpty() ? INDEX_NONE : Entries.First().Step; }
+	int64 GetNewestStep() const { return Entries.IsEmpty() ? INDEX_NONE : Entries.Last().Step; }
+	int64 GetUsedBytes() const;
+
+private:
+	struct FEntry
+	{
+		int64 Step;
+		int64 KeyframeStep;
+		int64 Offset;
+		int64 Size;
+	};
+
+	/** Encode State into EncodeScratch, as a keyframe or as a delta to CurrentKeyframe */
+	void Encode(const mjtNum* State, bool bKeyframe);
+
+	/** Evict old entries until Size bytes are free at the write head and return the write offset */
+	int64 MakeRoom(int64 Size);
+
+	/** Drop leading deltas whose keyframe has been evicted */
+	void EvictOrphans();
+
+	/** Reconstruct the state recorded by Entries[Index] into Out */
+	void Decode(int32 Index, mjtNum* Out) const;
+
+	int32 StateSize = 0;
+	int32 KeyframeInterval = 1;
+
+	TArray64<uint8> Storage;
+	int64 WriteHead = 0;
+	TRingBuffer<FEntry> Entries;
+
+	TArray<mjtNum> CurrentKeyframe;
+	int64 CurrentKeyframeStep = INDEX_NONE;
+
+	TArray<mjtNum> StateScratch;
+	TArray<uint8> EncodeScratch;
+};
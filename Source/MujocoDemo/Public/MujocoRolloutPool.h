@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <memory>
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+class FMujocoDataPool;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoRollout, Log, All);
+
+/**
+ * Running cost of a rollout, evaluated after every step. Called concurrently from worker
+ * threads, one rollout per call, so it must only read Data and its own captured state.
+ */
+using FMujocoRolloutCost = TFunctionRef<double(const mjModel* Model, const mjData* Data, int32 Rollout, int32 Step)>;
+
+/**
+ * Evaluates K candidate control sequences from a common start state, as needed by
+ * sampling-based controllers (MPPI, CEM). The rollout mjData buffers, costs and final
+ * states are acquired once in Initialize() and reused by every Run().
+ */
+class MUJOCODEMO_API FMujocoRolloutPool
+{
+public:
+	~FMujocoRolloutPool();
+
+	/**
+	 * Take NumRollouts rollout buffers for Model from the data pool.
+	 * @param FinalStateSpec mjtState bits captured from each rollout after its last step
+	 */
+	bool Initialize(const std::shared_ptr<FMujocoDataPool>& InDataPool, const mjModel* InModel, int32 NumRollouts,
+		uint32 FinalStateSpec = mjSTATE_FULLPHYSICS);
+
+	/** Return all rollout buffers to the data pool */
+	void Release();
+
+	/**
+	 * Clone Source into every rollout buffer and simulate Horizon steps in parallel.
+	 * @param Controls Candidate controls laid out [Rollout][Step][Actuator], NumRollouts * Horizon * nu values
+	 * @return False if the pool is not initialized or Controls has the wrong size
+	 */
+	bool Run(const mjData* Source, TArrayView<const double> Controls, int32 Horizon, FMujocoRolloutCost Cost);
+
+	bool IsInitialized() const { return Model != nullptr; }
+	const mjModel* GetModel() const { return Model; }
+	int32 GetNumRollouts() const { return Buffers.Num(); }
+
+	/** Accumulated cost per rollout from the last Run() */
+	TArrayView<const double> GetCosts() const { return Costs; }
+
+	/** State (FinalStateSpec) of a rollout after the last Run() */
+	TArrayView<const mjtNum> GetFinalState(int32 Rollout) const;
+
+	/** Index of the rollout with the lowest cost from the last Run() */
+	int32 GetBestRollout() const;
+
+private:
+	std::shared_ptr<FMujocoDataPool> DataPool;
+	const mjModel* Model = nullptr;
+	uint32 StateSpec = 0;
+	int32 StateSize = 0;
+
+	TArray<mjData*> Buffers;
+	TArray<double> Costs;
+	TArray<mjtNum> FinalStates;
+};
@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <memory>
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjspec.h>
+
+#include "CoreMinimal.h"
+#include "MujocoSceneBuilder.generated.h"
+
+class FMujocoAPI;
+
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoScene, Log, All);
+
+
+/**
+ * Contiguous id ranges of one robot spawned by FMujocoSceneBuilder.
+ *
+ * Each instance's subtree compiles to consecutive ids, so per-robot state is a slice of the
+ * model-wide arrays, e.g. qpos[FirstQpos .. FirstQpos + NumQpos).
+ */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoRobotInstance
+{
+	GENERATED_BODY()
+
+	/** Prefix given to every name in this instance */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	FString Prefix;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 RootBody = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 FirstBody = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 NumBodies = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 FirstJoint = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 NumJoints = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 FirstQpos = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 NumQpos = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 FirstDof = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 NumDofs = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 FirstGeom = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 NumGeoms = 0;
+
+	/** Actuators driving this instance's joints */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 FirstActuator = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Scene")
+	int32 NumActuators = 0;
+
+	bool IsValid() const { return RootBody != INDEX_NONE; }
+};
+
+/**
+ * Composes a scene from robot templates with mjSpec instead of one hand-written XML.
+ *
+ * Templates are parsed once; every instance attaches a prefixed copy of the template's
+ * top-level bodies, with the actuators and sensors that reference them, to a frame of the
+ * scene's world body at its placement. The scene compiles once after all instances are
+ * added, and the spec stays alive for later edits.
+ *
+ * Edits made after Compile are applied with Recompile, which rebuilds the model and data in
+ * place with mj_recompile so the state of untouched bodies carries over. The builder keeps the
+ * spec element behind every compiled geom, which is how a recompile reports where each old
+ * geom went. Remove bodies through RemoveBody so their geoms are dropped from that table
+ * before the spec frees them.
+ */
+class MUJOCODEMO_API FMujocoSceneBuilder
+{
+public:
+	explicit FMujocoSceneBuilder(std::shared_ptr<FMujocoAPI> InApi);
+	~FMujocoSceneBuilder();
+
+	FMujocoSceneBuilder(const FMujocoSceneBuilder&) = delete;
+	FMujocoSceneBuilder& operator=(const FMujocoSceneBuilder&) = delete;
+
+	/** Start from the scene in SceneXMLPath (floor, lights, options), or from an empty world if empty */
+	bool BeginScene(const FString& SceneXMLPath = FString());
+
+	/** Parse a robot model to instantiate; returns the template index or INDEX_NONE */
+	int32 AddTemplate(const FString& XMLPath);
+
+	/**
+	 * Place a copy of Template at Position / Rotation (MuJoCo world frame and units).
+	 * Names are prefixed with Prefix, which must be unique; an empty prefix generates one.
+	 * Returns the instance index, whose id ranges are filled in by Compile.
+	 */
+	int32 AddInstance(int32 Template, const FVector& Position, const FQuat& Rotation, FString Prefix = FString());
+
+	/** Compile the scene and resolve the instance id ranges; the caller owns the model */
+	mjModel* Compile();
+
+	/**
+	 * Add a body with one primitive geom under the world body; Size is the geom_size of Type.
+	 * Position / Rotation are in the MuJoCo world frame and units. Takes effect on Recompile.
+	 * Returns null, leaving the spec untouched, if Name is taken or the body cannot be built.
+	 */
+	mjsBody* AddPrimitiveBody(const FString& Name, mjtGeom Type, const FVector& Size, const FVector& Position, const FQuat& Rotation, double Mass, bool bFreeJoint);
+
+	/** Delete the named body, its subtree and everything referencing it. Takes effect on Recompile. */
+	bool RemoveBody(const FString& Name);
+
+	/**
+	 * Rebuild Model and Data in place from the edited spec, keeping the state of unchanged bodies.
+	 * OutGeomRemap maps each geom id of the old model to its id in the new one, or INDEX_NONE if
+	 * it was removed; new geoms are the ids no old geom maps to. On failure Model and Data are
+	 * left as they were and the bodies added since the last compile are deleted from the spec.
+	 */
+	bool Recompile(mjModel* Model, mjData* Data, TArray<int32>& OutGeomRemap);
+
+	mjSpec* GetSpec() const { return Spec; }
+	int32 GetNumTemplates() const { return Templates.Num(); }
+
+	/** Instances in the order they were added; ranges are valid after Compile */
+	const TArray<FMujocoRobotInstance>& GetInstances() const { return Instances; }
+
+private:
+	/** Free the scene and template specs */
+	void Reset();
+
+	/** Resolve every instance's ranges and the geom element table against Model */
+	void IndexModel(const mjModel* Model);
+
+	/** Fill Instance's ranges from the subtrees rooted at RootBodies in Model */
+	static bool ResolveRanges(const mjModel* Model, TConstArrayView<int32> RootBodies, FMujocoRobotInstance& Instance);
+
+	std::shared_ptr<FMujocoAPI> Api;
+	mjSpec* Spec = nullptr;
+	TArray<mjSpec*> Templates;
+	TArray<FMujocoRobotInstance> Instances;
+
+	/** Attached top-level bodies of each instance, for looking up their compiled ids */
+	TArray<TArray<mjsBody*>> InstanceRoots;
+
+	/** Spec element of each geom id of the last compilation; null once removed */
+	TArray<mjsElement*> GeomElements;
+
+	/** Bodies added by AddPrimitiveBody since the last compile, deleted again if it fails */
+	TArray<mjsBody*> PendingBodies;
+};
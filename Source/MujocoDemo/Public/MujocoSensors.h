@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "MujocoSensors.generated.h"
+
+class FMujocoNameIndex;
+
+
+/** Location of one sensor's values in mjData::sensordata, resolved once per model */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoSensorHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Sensors")
+	int32 Id = INDEX_NONE;
+
+	/** Offset into sensordata (sensor_adr) */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Sensors")
+	int32 Address = 0;
+
+	/** Number of values (sensor_dim) */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Sensors")
+	int32 Dimension = 0;
+
+	/** Table build the handle was resolved against; reads through a later build are refused */
+	UPROPERTY()
+	int32 Generation = 0;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+/** A set of sensors read together; resolve it once and copy it out every frame */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoSensorBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Sensors")
+	TArray<FMujocoSensorHandle> Sensors;
+
+	/** Sum of the sensor dimensions, i.e. the number of values one read produces */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Sensors")
+	int32 NumValues = 0;
+
+	/** Table build the batch was resolved against */
+	UPROPERTY()
+	int32 Generation = 0;
+};
+
+/**
+ * Name to sensordata layout table for one model.
+ *
+ * Handles only store offsets, so views are made against whichever mjData is current and
+ * stay valid across arena resizes and rewinds. Every Build starts a new generation: handles
+ * and batches resolved before a model reload or scene edit are refused rather than read at
+ * offsets of the old layout.
+ */
+class MUJOCODEMO_API FMujocoSensorTable
+{
+public:
+	/** Names resolve through Names, which must outlive the table */
+	void Build(const mjModel* Model, const FMujocoNameIndex& Names);
+	void Reset();
+
+	/** Invalid handle if the model has no sensor called Name */
+	FMujocoSensorHandle Find(FName Name) const;
+
+	/** Resolve Names in order; unknown names are skipped and reported through OutMissing */
+	FMujocoSensorBatch Resolve(TConstArrayView<FName> Names, TArray<FName>* OutMissing = nullptr) const;
+
+	int32 Num() const { return Handles.Num(); }
+
+	/** Whether Sensor was resolved by the current build and lies within its sensordata */
+	bool IsCurrent(const FMujocoSensorHandle& Sensor) const
+	{
+		return Sensor.IsValid() && Sensor.Generation == Generation && Sensor.Address >= 0 && Sensor.Address + Sensor.Dimension <= NumSensorData;
+	}
+
+	/** Read-only view of one sensor's values in Data; empty for a stale handle */
+	TArrayView<const mjtNum> View(const mjData* Data, const FMujocoSensorHandle& Sensor) const
+	{
+		return Data && IsCurrent(Sensor) ? TArrayView<const mjtNum>(Data->sensordata + Sensor.Address, Sensor.Dimension) : TArrayView<const mjtNum>();
+	}
+
+	/**
+	 * Append the values of every sensor in Batch to Out, which keeps its allocation between calls.
+	 * Returns false without appending anything if Batch was resolved against another build.
+	 */
+	bool Copy(const mjData* Data, const FMujocoSensorBatch& Batch, TArray<double>& Out) const;
+
+private:
+	TArray<FMujocoSensorHandle> Handles;
+	const FMujocoNameIndex* NameIndex = nullptr;
+	int32 Generation = 0;
+	int32 NumSensorData = 0;
+};
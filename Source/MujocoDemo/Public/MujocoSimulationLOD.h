@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MujocoSimulationLOD.generated.h"
+
+
+/** How much simulation and rendering work a manager gets, by its distance from the viewer */
+UENUM(BlueprintType)
+enum class EMujocoSimulationLOD : uint8
+{
+	/** Full step rate, synced every frame */
+	Near,
+
+	/** Reduced step rate, rendered with interpolated poses */
+	Mid,
+
+	/** Low step rate or frozen; components keep their last pose */
+	Far,
+};
+
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoLODSettings
+{
+	GENERATED_BODY()
+
+	/** Pick the level from the viewer's distance; otherwise the manager always runs at Near */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD")
+	bool bEnabled = false;
+
+	/** Distance (Unreal units) from the viewer to the model's center of mass beyond which it drops to Mid */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD", meta=(ClampMin="0.0"))
+	double MidDistance = 3000.0;
+
+	/** Distance beyond which the model drops to Far */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD", meta=(ClampMin="0.0"))
+	double FarDistance = 10000.0;
+
+	/** Fraction of the full step rate at Mid; simulated time runs correspondingly slower */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD", meta=(ClampMin="0.0", ClampMax="1.0"))
+	double MidStepRate = 0.5;
+
+	/** Fraction of the full step rate at Far, unless frozen */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD", meta=(ClampMin="0.0", ClampMax="1.0"))
+	double FarStepRate = 0.1;
+
+	/** Stop stepping at Far and resume from where it stopped once the viewer comes back */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD")
+	bool bFreezeWhenFar = false;
+
+	/** Fraction of a threshold the distance must pass it by to change level, so a viewer on the boundary does not flicker */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="MuJoCo|LOD", meta=(ClampMin="0.0", ClampMax="0.5"))
+	double Hysteresis = 0.1;
+};
+
+/**
+ * Current simulation LOD of one manager and whether it is frozen.
+ *
+ * Lower levels trade simulated time for cost: the step clock accumulates only StepRate of the
+ * wall-clock time, so a distant model runs in slow motion rather than with a larger, less
+ * stable timestep. A frozen model is not stepped, so it resumes from its current state, which
+ * includes any reset or rewind made meanwhile, without a burst of catch-up steps.
+ */
+class MUJOCODEMO_API FMujocoSimulationLOD
+{
+public:
+	/** Pick the level for Distance, changing level only once it is passed by the hysteresis margin */
+	EMujocoSimulationLOD Update(const FMujocoLODSettings& Settings, double Distance);
+
+	/** Return to Near, e.g. when LOD is turned off or the model changes */
+	void ForceNear() { Level = EMujocoSimulationLOD::Near; }
+
+	EMujocoSimulationLOD GetLevel() const { return Level; }
+
+	/** Fraction of the full step rate for the current level; 0 while frozen */
+	double GetStepRate(const FMujocoLODSettings& Settings) const;
+
+	/** Whether mesh components, sensors and cameras follow the simulation at this level */
+	bool ShouldSync() const { return Level != EMujocoSimulationLOD::Far; }
+
+	bool IsFrozen() const { return bFrozen; }
+
+	/** Stop stepping until Thaw */
+	void Freeze() { bFrozen = true; }
+
+	/** Resume stepping */
+	void Thaw() { bFrozen = false; }
+
+	/** Unfreeze and return to Near */
+	void Release();
+
+private:
+	EMujocoSimulationLOD Level = EMujocoSimulationLOD::Near;
+	bool bFrozen = false;
+};
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <atomic>
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/RingBuffer.h"
+#include "MujocoSensors.h"
+
+class FSocket;
+class FRunnableThread;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoStateStreamer, Log, All);
+
+/** Fixed part of every streamed frame; followed by NumPositions qpos doubles and NumSensorValues sensor doubles */
+#pragma pack(push, 1)
+struct FMujocoStreamFrameHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x46534A4D; // "MJSF"
+
+	uint32 Magic;
+	/** Bytes in the whole frame, header included */
+	uint32 Size;
+	double Time;
+	int64 Step;
+	uint32 NumPositions;
+	uint32 NumSensorValues;
+	uint32 NumContacts;
+};
+#pragma pack(pop)
+
+/**
+ * Streams compact binary state frames to local subscribers over TCP.
+ *
+ * Publish() runs on the simulation thread and only serializes the frame once and hands a shared
+ * reference to each client whose rate limit allows it. A background thread does all socket work.
+ * Every client has a small queue that drops its oldest frame when full, so a slow or stalled
+ * reader only loses frames and never blocks stepping.
+ *
+ * A client may send a little-endian uint32 at any time to set its own maximum rate in Hz.
+ */
+class MUJOCODEMO_API FMujocoStateStreamer : public FRunnable
+{
+public:
+	virtual ~FMujocoStateStreamer() override;
+
+	/** Listen on Port; loopback only unless bAllowRemote */
+	bool Start(int32 Port, bool bAllowRemote, double DefaultMaxRateHz, int32 QueueDepth);
+
+	/** Disconnect every client and join the server thread */
+	void Shutdown();
+
+	bool IsRunning() const { return Thread != nullptr; }
+	int32 GetNumClients() const { return NumClients.load(std::memory_order_relaxed); }
+	uint64 GetDroppedFrames() const { return DroppedFrames.load(std::memory_order_relaxed); }
+
+	/** Serialize the state in Data and queue it for every client that is due a frame */
+	void Publish(const mjModel* Model, const mjData* Data, int64 Step, const FMujocoSensorBatch& Sensors);
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	using FFrame = TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe>;
+
+	struct FClient
+	{
+		FSocket* Socket = nullptr;
+		double MinInterval = 0.0;
+		double NextFrameTime = 0.0;
+
+		/** Guarded by the streamer's ClientsLock */
+		TRingBuffer<FFrame> Queue;
+
+		/** Owned by the server thread: frame being sent and how much of it has gone out */
+		TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Sending;
+		int32 SendOffset = 0;
+	};
+
+	void AcceptClients();
+
+	/** Returns false once the client should be dropped */
+	bool ServiceClient(FClient& Client);
+
+	void CloseClient(FClient& Client) const;
+
+	FSocket* ListenSocket = nullptr;
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	std::atomic<bool> bStopping{false};
+
+	FCriticalSection ClientsLock;
+	TArray<TUniquePtr<FClient>> Clients;
+
+	double DefaultMinInterval = 0.0;
+	int32 MaxQueuedFrames = 8;
+
+	std::atomic<int32> NumClients{0};
+	std::atomic<uint64> DroppedFrames{0};
+};
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MujocoStepClock.generated.h"
+
+
+/** How simulated time relates to wall-clock time */
+UENUM(BlueprintType)
+enum class EMujocoStepMode : uint8
+{
+	/** One simulated second per wall-clock second */
+	RealTime,
+
+	/** TimeScale simulated seconds per wall-clock second */
+	Scaled,
+
+	/** As many steps as fit in the frame budget, regardless of wall-clock time; for headless data generation */
+	AsFastAsPossible,
+};
+
+/** Stepping statistics since the model was loaded */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoStepClockStats
+{
+	GENERATED_BODY()
+
+	/** Simulated seconds per wall-clock second, smoothed over roughly a second */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Stepping")
+	double RealtimeFactor = 0.0;
+
+	/** Physics steps per wall-clock second, smoothed like RealtimeFactor */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Stepping")
+	double StepsPerSecond = 0.0;
+
+	/** Frames on which the step cap was hit and the backlog was dropped */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Stepping")
+	int64 CappedFrames = 0;
+
+	/** Simulated seconds skipped to keep the frame rate up */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Stepping")
+	double DroppedSeconds = 0.0;
+};
+
+/**
+ * Decides how many physics steps of the model's own timestep each frame takes.
+ *
+ * Wall-clock time, scaled by the mode, accumulates and is spent in whole steps; the remainder
+ * carries to the next frame. When a frame would need more than the step cap, the backlog is
+ * dropped instead of carried, so a simulation that cannot keep up slows down rather than
+ * spending ever longer frames catching up.
+ */
+class MUJOCODEMO_API FMujocoStepClock
+{
+public:
+	void Reset();
+
+	/**
+	 * Start a frame of DeltaTime wall seconds and return how many steps of Timestep to take.
+	 * Rate scales the result below the mode's full rate, for simulation LOD. In AsFastAsPossible
+	 * mode the count is unbounded (MAX_int32, or 0 at a zero rate) and the caller stops at its
+	 * frame budget instead; MaxStepsPerFrame only caps the other modes.
+	 */
+	int32 BeginFrame(double DeltaTime, double Timestep, EMujocoStepMode Mode, double TimeScale, int32 MaxStepsPerFrame, double Rate = 1.0);
+
+	/** Record the steps actually taken in the frame started by BeginFrame */
+	void EndFrame(int32 StepsTaken, double Timestep);
+
+	/** Fraction of a step accumulated but not yet simulated, for interpolating between steps */
+	double GetAlpha(double Timestep) const { return Timestep > 0.0 ? FMath::Clamp(Accumulated / Timestep, 0.0, 1.0) : 0.0; }
+
+	/** Forget time owed, e.g. after a rewind; the statistics are kept */
+	void DiscardBacklog() { Accumulated = 0.0; }
+
+	const FMujocoStepClockStats& GetStats() const { return Stats; }
+
+private:
+	double Accumulated = 0.0;
+	double FrameDeltaTime = 0.0;
+	FMujocoStepClockStats Stats;
+};
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <mujoco/mjmodel.h>
+#include <mujoco/mjdata.h>
+
+#include "CoreMinimal.h"
+
+class FMujocoAPI;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoTrajectory, Log, All);
+
+/**
+ * On-disk layout of a recorded trajectory:
+ *
+ *   [Header][Frame 0][Frame 1]...[Frame N-1][Chunk 0]...[Chunk C-1]
+ *
+ * Every frame is StateSize mjtNum values written by mj_getState(StateSpec), so the
+ * first value of a frame is always the simulation time. Frames are fixed size and their
+ * times never decrease; the chunk index at the end of the file holds the start time of
+ * every FramesPerChunk frames, so a reader finds any timestamp with two binary searches
+ * instead of a scan.
+ */
+struct FMujocoTrajectoryHeader
+{
+	static constexpr uint32 MagicValue = 0x52544A4D; // "MJTR"
+	static constexpr uint32 CurrentVersion = 2;
+
+	uint32 Magic = MagicValue;
+	uint32 Version = CurrentVersion;
+	uint32 StateSpec = 0;
+	uint32 StateSize = 0;
+	uint32 FramesPerChunk = 0;
+	uint32 ChunkCount = 0;
+	int32 Nq = 0;
+	int32 Nmocap = 0;
+	uint64 FrameCount = 0;
+	uint64 IndexOffset = 0;
+	double Timestep = 0.0;
+	uint64 Reserved = 0;
+};
+static_assert(sizeof(FMujocoTrajectoryHeader) % sizeof(mjtNum) == 0, "Frames must stay mjtNum aligned");
+
+/** One entry of the chunk index, pointing at the first frame of a chunk */
+struct FMujocoTrajectoryChunk
+{
+	double StartTime = 0.0;
+	uint64 FirstFrame = 0;
+};
+
+/**
+ * Streams one state frame per physics step into a trajectory file. Time must not run
+ * backwards within a recording; a reset or rewind ends it.
+ */
+class MUJOCODEMO_API FMujocoTrajectoryWriter
+{
+public:
+	/** State recorded by default: enough to reproduce all geom poses with mj_kinematics */
+	static constexpr uint32 DefaultStateSpec = mjSTATE_TIME | mjSTATE_QPOS | mjSTATE_MOCAP_POS | mjSTATE_MOCAP_QUAT;
+
+	~FMujocoTrajectoryWriter();
+
+	/** Create the file and write a placeholder header. Closes any previous recording. */
+	bool Open(const FString& FilePath, const FMujocoAPI& Api, const mjModel* Model,
+		uint32 StateSpec = DefaultStateSpec, uint32 FramesPerChunk = 1024);
+
+	/** Append the current state of Data as the next frame; false if its time is before the last frame's */
+	bool Append(const FMujocoAPI& Api, const mjModel* Model, const mjData* Data);
+
+	/** Write the chunk index and final header, then close the file */
+	void Close();
+
+	bool IsOpen() const { return Archive.IsValid(); }
+	uint64 GetFrameCount() const { return Header.FrameCount; }
+
+private:
+	TUniquePtr<FArchive> Archive;
+	FMujocoTrajectoryHeader Header;
+	TArray<FMujocoTrajectoryChunk> Chunks;
+	TArray<mjtNum> FrameScratch;
+	double LastTime = 0.0;
+};
+
+/**
+ * Memory-maps a trajectory file for random access playback. Only the pages around the
+ * frames that are actually visited get paged in, so scrubbing long recordings stays cheap.
+ */
+class MUJOCODEMO_API FMujocoTrajectoryReader
+{
+public:
+	~FMujocoTrajectoryReader();
+
+	/** Map the file and validate it against the model that will replay it */
+	bool Open(const FString& FilePath, const FMujocoAPI& Api, const mjModel* Model);
+	void Close();
+
+	bool IsOpen() const { return Frames != nullptr; }
+	int64 GetFrameCount() const { return static_cast<int64>(Header.FrameCount); }
+	double GetStartTime() const;
+	double GetEndTime() const;
+
+	/** Nearest frame to Time in O(log n) through the chunk index; the result is clamped to the recording */
+	int64 FindFrame(double Time) const;
+
+	/** Pointer to the StateSize values of a frame, or nullptr if out of range */
+	const mjtNum* GetFrame(int64 FrameIndex) const;
+
+	/** Write a frame into Data. Kinematics are left to the caller. */
+	bool ApplyFrame(int64 FrameIndex, const FMujocoAPI& Api, const mjModel* Model, mjData* Data) const;
+
+private:
+	double GetFrameTime(int64 FrameIndex) const { return Frames[FrameIndex * Header.StateSize]; }
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	FMujocoTrajectoryHeader Header;
+	const mjtNum* Frames = nullptr;
+	const FMujocoTrajectoryChunk* Chunks = nullptr;
+};
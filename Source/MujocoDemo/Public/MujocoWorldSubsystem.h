@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MujocoWorldSubsystem.generated.h"
+
+class AMujocoManager;
+
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMujocoWorlds, Log, All);
+
+
+/** Cost of the last frame of the world subsystem */
+USTRUCT(BlueprintType)
+struct MUJOCODEMO_API FMujocoWorldFrameStats
+{
+	GENERATED_BODY()
+
+	/** Managers stepped this frame */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	int32 NumWorlds = 0;
+
+	/** Wall-clock time of the concurrent stepping phase */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	double StepMilliseconds = 0.0;
+
+	/** Longest time any one manager spent stepping; StepMilliseconds approaches it when workers are free */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	double SlowestWorldMilliseconds = 0.0;
+
+	/** Sum of every manager's stepping time, what a serial loop would have cost */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	double TotalWorldMilliseconds = 0.0;
+
+	/** Game-thread time syncing components, sensors and debug drawing of all managers */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	double SyncMilliseconds = 0.0;
+
+	/** Steps per second all managers skip through their simulation LOD */
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	double LODStepsSavedPerSecond = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	int32 NumMidWorlds = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	int32 NumFarWorlds = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="MuJoCo|Worlds")
+	int32 NumFrozenWorlds = 0;
+};
+
+/**
+ * Owns the MuJoCo managers of a world and ticks them as one batch.
+ *
+ * Every manager holds its own model, data and pools, so their physics steps share nothing and
+ * run concurrently on the task graph. Once all have finished, the game thread syncs each
+ * manager's components in one pass. A frame then costs about the slowest manager plus the
+ * sync, rather than the sum of all managers.
+ */
+UCLASS()
+class MUJOCODEMO_API UMujocoWorldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterManager(AMujocoManager* Manager);
+	void UnregisterManager(AMujocoManager* Manager);
+
+	const TArray<TObjectPtr<AMujocoManager>>& GetManagers() const { return Managers; }
+
+	/** Camera location of the first local player, which simulation LOD is measured from */
+	static bool GetViewLocation(const UWorld* World, FVector& OutLocation);
+
+	UFUNCTION(BlueprintPure, Category="MuJoCo|Worlds")
+	FMujocoWorldFrameStats GetFrameStats() const { return FrameStats; }
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AMujocoManager>> Managers;
+
+	/** Stepping time of each manager this frame, written by its worker */
+	TArray<double> WorldMilliseconds;
+
+	FMujocoWorldFrameStats FrameStats;
+};